@@ -0,0 +1,207 @@
+#include "BenchmarkSupport.h"
+#include "NativeClock.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+// *************
+// JsonLine
+// *************
+
+void JsonLine::Name(const char* name) {
+	text_ << (text_.tellp() == std::streampos(0) ? "{\"" : ",\"") << name << "\":";
+}
+
+JsonLine& JsonLine::Add(const char* name, const std::string& value) {
+	Name(name);
+	text_ << '"';
+	for (size_t i = 0; i < value.size(); i++) {
+		char c = value[i];
+		if (c == '"' || c == '\\')
+			text_ << '\\' << c;
+		else if ((unsigned char)c < 0x20) {
+			char escaped[8];
+			sprintf(escaped, "\\u%04x", c);
+			text_ << escaped;
+		}
+		else
+			text_ << c;
+	}
+	text_ << '"';
+	return *this;
+}
+
+JsonLine& JsonLine::Add(const char* name, const char* value) {
+	return Add(name, std::string(value));
+}
+
+JsonLine& JsonLine::Add(const char* name, __int64 value) {
+	Name(name);
+	text_ << value;
+	return *this;
+}
+
+JsonLine& JsonLine::Add(const char* name, int value) {
+	return Add(name, (__int64)value);
+}
+
+JsonLine& JsonLine::Add(const char* name, double value) {
+	Name(name);
+	char formatted[32];
+	sprintf(formatted, "%.6g", value);
+	text_ << formatted;
+	return *this;
+}
+
+void JsonLine::Print() {
+	text_ << '}';
+	printf("%s\n", text_.str().c_str());
+	fflush(stdout);
+}
+
+// *************
+// Stopwatch
+// *************
+
+Stopwatch::Stopwatch() : start_(NativeClockTicks()) {
+}
+
+double Stopwatch::Seconds() const {
+	return (double)(NativeClockTicks() - start_) / NativeClockFrequency();
+}
+
+// *************
+// Keys and values
+// *************
+
+void FillKey(__int64 index, Byte* key, int keySize) {
+	for (int i = 0; i < 8; i++)
+		key[i] = (Byte)(index >> (56 - 8 * i));
+	memset(key + 8, 'k', keySize - 8);
+}
+
+void FillValue(__int64 index, Byte* value, int valueSize) {
+	unsigned __int64 state = (unsigned __int64)index * 0x9E3779B97F4A7C15ull + 1;
+	for (int i = 0; i < valueSize; i++) {
+		state ^= state << 13;
+		state ^= state >> 7;
+		state ^= state << 17;
+		value[i] = (Byte)state;
+	}
+}
+
+// *************
+// Parsing
+// *************
+
+__int64 ParseSize(const std::string& text) {
+	char* end;
+	__int64 value = strtoll(text.c_str(), &end, 10);
+	std::string unit(end);
+	if (unit == "KB" || unit == "K")
+		return value << 10;
+	if (unit == "MB" || unit == "M")
+		return value << 20;
+	if (unit == "GB" || unit == "G")
+		return value << 30;
+	return value;
+}
+
+std::vector<std::string> Split(const std::string& text, char separator) {
+	std::vector<std::string> result;
+	size_t start = 0;
+	while (true) {
+		size_t end = text.find(separator, start);
+		result.push_back(text.substr(start, end == std::string::npos ? std::string::npos : end - start));
+		if (end == std::string::npos)
+			return result;
+		start = end + 1;
+	}
+}
+
+// *************
+// WiredTiger
+// *************
+
+void MakeDirectory(const std::string& path) {
+#ifdef _WIN32
+	int r = _mkdir(path.c_str());
+#else
+	int r = mkdir(path.c_str(), 0755);
+#endif
+	if (r != 0 && errno != EEXIST)
+		throw NativeWiredTigerApiException(errno, "mkdir, " + path);
+}
+
+WT_CONNECTION* OpenConnection(const std::string& home, const std::string& config) {
+	WT_CONNECTION* connection;
+	int r = wiredtiger_open(home.c_str(), nullptr, config.c_str(), &connection);
+	if (r != 0)
+		throw NativeWiredTigerApiException(r, "wiredtiger_open, " + home);
+	return connection;
+}
+
+WT_SESSION* OpenSession(WT_CONNECTION* connection) {
+	WT_SESSION* session;
+	Check(connection->open_session(connection, nullptr, nullptr, &session), "connection->open_session");
+	return session;
+}
+
+void Check(int r, const char* apiName) {
+	if (r != 0)
+		throw NativeWiredTigerApiException(r, apiName);
+}
+
+// *************
+// LatencyProbe
+// *************
+
+LatencyProbe::LatencyProbe(const std::string& table, NativeLatencyOp op) : table_(table), op_(op) {
+	if (!Find(before_))
+		before_.buckets.assign(latencyBucketCount, 0);
+}
+
+bool LatencyProbe::Find(NativeLatencySnapshot& result) {
+	std::vector<NativeLatencySnapshot> snapshots;
+	SnapshotLatency(snapshots);
+	for (size_t i = 0; i < snapshots.size(); i++)
+		if (snapshots[i].table == table_ && snapshots[i].op == op_) {
+			result = snapshots[i];
+			return true;
+		}
+	return false;
+}
+
+void LatencyProbe::Report(JsonLine& line) {
+	NativeLatencySnapshot after;
+	if (!IsLatencyTracking() || !Find(after))
+		return;
+	std::vector<__int64> buckets(latencyBucketCount);
+	__int64 count = 0;
+	for (int i = 0; i < latencyBucketCount; i++) {
+		buckets[i] = after.buckets[i] - before_.buckets[i];
+		count += buckets[i];
+	}
+	if (count == 0)
+		return;
+	__int64 p50 = -1;
+	__int64 p99 = -1;
+	__int64 max = 0;
+	__int64 seen = 0;
+	for (int i = 0; i < latencyBucketCount; i++) {
+		if (buckets[i] == 0)
+			continue;
+		seen += buckets[i];
+		if (p50 < 0 && seen * 100 >= count * 50)
+			p50 = LatencyBucketUpperBound(i);
+		if (p99 < 0 && seen * 100 >= count * 99)
+			p99 = LatencyBucketUpperBound(i);
+		max = LatencyBucketUpperBound(i);
+	}
+	line.Add("p50Ns", p50).Add("p99Ns", p99).Add("maxNs", max);
+}
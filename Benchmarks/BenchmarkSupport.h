@@ -0,0 +1,54 @@
+#pragma once
+#include "NativeTiger.h"
+#include "NativeLatency.h"
+#include <random>
+#include <sstream>
+
+// One result per line of stdout, {"benchmark":"search","keySize":16,...}
+class JsonLine {
+public:
+	JsonLine& Add(const char* name, const std::string& value);
+	JsonLine& Add(const char* name, const char* value);
+	JsonLine& Add(const char* name, __int64 value);
+	JsonLine& Add(const char* name, int value);
+	JsonLine& Add(const char* name, double value);
+	void Print();
+private:
+	void Name(const char* name);
+	std::ostringstream text_;
+};
+
+class Stopwatch {
+public:
+	Stopwatch();
+	double Seconds() const;
+private:
+	__int64 start_;
+};
+
+// Fixed size keys that sort by index: 8 bytes of big-endian index padded with 'k'
+void FillKey(__int64 index, Byte* key, int keySize);
+// Deterministic value bytes, different for neighbouring indexes
+void FillValue(__int64 index, Byte* value, int valueSize);
+
+// Parses 64MB, 1GB, 4096 and the like
+__int64 ParseSize(const std::string& text);
+std::vector<std::string> Split(const std::string& text, char separator);
+
+void MakeDirectory(const std::string& path);
+WT_CONNECTION* OpenConnection(const std::string& home, const std::string& config);
+WT_SESSION* OpenSession(WT_CONNECTION* connection);
+void Check(int r, const char* apiName);
+
+// Latencies recorded by NativeCursor for one table and operation between two points of time
+class LatencyProbe {
+public:
+	LatencyProbe(const std::string& table, NativeLatencyOp op);
+	// Adds p50Ns, p99Ns and maxNs of operations since construction when latency tracking is on
+	void Report(JsonLine& line);
+private:
+	std::string table_;
+	NativeLatencyOp op_;
+	NativeLatencySnapshot before_;
+	bool Find(NativeLatencySnapshot& result);
+};
@@ -0,0 +1,178 @@
+#include "CursorBenchmarks.h"
+#include "BenchmarkSupport.h"
+#include <algorithm>
+#include <climits>
+#include <memory>
+
+namespace {
+	struct CursorRun {
+		const CursorBenchmarkOptions* options;
+		WT_SESSION* session;
+		std::string uri;
+		std::string cacheSize;
+		std::string tableConfig;
+		int keySize;
+		int valueSize;
+		// indexes of all rows in random order
+		std::vector<__int64> order;
+	};
+
+	void Report(const CursorRun& run, const char* benchmark, __int64 operations, double seconds, LatencyProbe& probe) {
+		JsonLine line;
+		line.Add("benchmark", benchmark)
+			.Add("keySize", run.keySize)
+			.Add("valueSize", run.valueSize)
+			.Add("cacheSize", run.cacheSize)
+			.Add("tableConfig", run.tableConfig)
+			.Add("rows", run.options->rows)
+			.Add("operations", operations)
+			.Add("seconds", seconds)
+			.Add("opsPerSecond", seconds > 0 ? operations / seconds : 0.0)
+			.Add("nsPerOperation", operations > 0 ? seconds * 1e9 / operations : 0.0);
+		probe.Report(line);
+		line.Print();
+	}
+
+	void Insert(CursorRun& run, NativeCursor* cursor) {
+		std::vector<Byte> key(run.keySize);
+		std::vector<Byte> value(run.valueSize);
+		LatencyProbe probe(run.uri, NativeLatencyInsert);
+		Stopwatch stopwatch;
+		for (size_t i = 0; i < run.order.size(); i++) {
+			FillKey(run.order[i], key.data(), run.keySize);
+			FillValue(run.order[i], value.data(), run.valueSize);
+			cursor->Insert(key.data(), run.keySize, value.data(), run.valueSize);
+		}
+		Report(run, "insert", (__int64)run.order.size(), stopwatch.Seconds(), probe);
+	}
+
+	void Search(CursorRun& run, NativeCursor* cursor) {
+		std::vector<Byte> key(run.keySize);
+		size_t checksum = 0;
+		LatencyProbe probe(run.uri, NativeLatencySearch);
+		Stopwatch stopwatch;
+		for (size_t i = 0; i < run.order.size(); i++) {
+			FillKey(run.order[i], key.data(), run.keySize);
+			WT_ITEM value;
+			if (!cursor->Get(key.data(), run.keySize, &value))
+				throw NativeWiredTigerApiException(WT_NOTFOUND, "search");
+			checksum += value.size;
+		}
+		double seconds = stopwatch.Seconds();
+		cursor->Reset();
+		if (checksum != run.order.size() * run.valueSize)
+			throw NativeWiredTigerApiException(WT_ERROR, "search, unexpected value size");
+		Report(run, "search", (__int64)run.order.size(), seconds, probe);
+	}
+
+	// Probes fall between neighbouring keys, so search_near never finds an exact match
+	void SearchNear(CursorRun& run, NativeCursor* cursor) {
+		std::vector<Byte> key(run.keySize + 1);
+		LatencyProbe probe(run.uri, NativeLatencySearchNear);
+		Stopwatch stopwatch;
+		for (size_t i = 0; i < run.order.size(); i++) {
+			FillKey(run.order[i], key.data(), run.keySize);
+			key[run.keySize] = 0;
+			int exact;
+			if (!cursor->SearchNear(key.data(), run.keySize + 1, &exact) || exact == 0)
+				throw NativeWiredTigerApiException(WT_ERROR, "search_near, unexpected result");
+		}
+		double seconds = stopwatch.Seconds();
+		cursor->Reset();
+		Report(run, "search_near", (__int64)run.order.size(), seconds, probe);
+	}
+
+	void Scan(CursorRun& run, NativeCursor* cursor, NativeDirection direction) {
+		const char* name = direction == Ascending ? "scan_forward" : "scan_backward";
+		__int64 rows = 0;
+		size_t checksum = 0;
+		LatencyProbe probe(run.uri, direction == Ascending ? NativeLatencyNext : NativeLatencyPrev);
+		Stopwatch stopwatch;
+		if (cursor->IterationBegin(nullptr, 0, false, nullptr, 0, false, direction, false))
+			do {
+				// touch the row as a reader would
+				checksum += cursor->KeyView().size + cursor->ValueView().size;
+				rows++;
+			} while (cursor->IterationMove());
+		double seconds = stopwatch.Seconds();
+		cursor->Reset();
+		if (rows != run.options->rows || checksum != (size_t)rows * (run.keySize + run.valueSize))
+			throw NativeWiredTigerApiException(WT_ERROR, std::string(name) + ", unexpected rows");
+		Report(run, name, rows, seconds, probe);
+	}
+
+	void TotalCount(CursorRun& run, NativeCursor* cursor) {
+		LatencyProbe probe(run.uri, NativeLatencyNext);
+		Stopwatch stopwatch;
+		__int64 rows = cursor->GetTotalCount(nullptr, 0, false, nullptr, 0, false, LLONG_MAX);
+		double seconds = stopwatch.Seconds();
+		cursor->Reset();
+		if (rows != run.options->rows)
+			throw NativeWiredTigerApiException(WT_ERROR, "total_count, unexpected rows");
+		Report(run, "total_count", rows, seconds, probe);
+	}
+
+	bool Selected(const CursorBenchmarkOptions& options, const char* name) {
+		return options.benchmarks.empty() ||
+			std::find(options.benchmarks.begin(), options.benchmarks.end(), name) != options.benchmarks.end();
+	}
+
+	void RunOne(CursorRun& run) {
+		const CursorBenchmarkOptions& options = *run.options;
+		std::string config = "key_format=u,value_format=u";
+		if (!run.tableConfig.empty())
+			config += "," + run.tableConfig;
+		Check(run.session->create(run.session, run.uri.c_str(), config.c_str()), "session->create");
+		std::unique_ptr<NativeCursor> cursor(OpenNativeCursor(run.session, run.uri.c_str(), nullptr));
+		// every other benchmark reads the loaded table, so the load always runs
+		Insert(run, cursor.get());
+		if (Selected(options, "search"))
+			Search(run, cursor.get());
+		if (Selected(options, "search_near"))
+			SearchNear(run, cursor.get());
+		if (Selected(options, "scan_forward"))
+			Scan(run, cursor.get(), Ascending);
+		if (Selected(options, "scan_backward"))
+			Scan(run, cursor.get(), Descending);
+		if (Selected(options, "total_count"))
+			TotalCount(run, cursor.get());
+	}
+}
+
+void RunCursorBenchmarks(const CursorBenchmarkOptions& options) {
+	std::mt19937_64 random(options.seed);
+	std::vector<__int64> order((size_t)options.rows);
+	for (size_t i = 0; i < order.size(); i++)
+		order[i] = (__int64)i;
+	MakeDirectory(options.home);
+	int runNumber = 0;
+	for (size_t c = 0; c < options.cacheSizes.size(); c++)
+		for (size_t t = 0; t < options.tableConfigs.size(); t++)
+			for (size_t k = 0; k < options.keySizes.size(); k++)
+				for (size_t v = 0; v < options.valueSizes.size(); v++) {
+					std::string home = options.home + "/cursor" + std::to_string(runNumber);
+					MakeDirectory(home);
+					WT_CONNECTION* connection = OpenConnection(home,
+						"create,log=(enabled=false),cache_size=" + options.cacheSizes[c]);
+					try {
+						CursorRun run;
+						run.options = &options;
+						run.session = OpenSession(connection);
+						// table names differ between runs to keep latency histograms apart
+						run.uri = "table:cursor" + std::to_string(runNumber);
+						run.cacheSize = options.cacheSizes[c];
+						run.tableConfig = options.tableConfigs[t];
+						run.keySize = options.keySizes[k];
+						run.valueSize = options.valueSizes[v];
+						std::shuffle(order.begin(), order.end(), random);
+						run.order = order;
+						RunOne(run);
+					}
+					catch (...) {
+						connection->close(connection, nullptr);
+						throw;
+					}
+					connection->close(connection, nullptr);
+					runNumber++;
+				}
+}
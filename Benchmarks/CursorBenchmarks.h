@@ -0,0 +1,22 @@
+#pragma once
+#include <string>
+#include <vector>
+
+struct CursorBenchmarkOptions {
+	// Every run gets a fresh subdirectory of home
+	std::string home;
+	__int64 rows;
+	std::vector<int> keySizes;
+	std::vector<int> valueSizes;
+	// WiredTiger cache_size values, e.g. 64MB
+	std::vector<std::string> cacheSizes;
+	// Appended to key_format=u,value_format=u when the table is created
+	std::vector<std::string> tableConfigs;
+	// Names of benchmarks to run, all when empty
+	std::vector<std::string> benchmarks;
+	unsigned int seed;
+};
+
+// Runs insert, search, search_near, scan_forward, scan_backward and total_count through NativeCursor
+// for every combination of cache size, table config, key size and value size, one JSON line per result
+void RunCursorBenchmarks(const CursorBenchmarkOptions& options);
@@ -0,0 +1,7 @@
+#pragma once
+// The native WiredTigerNet sources are written against MSVC, this lets g++ and clang compile them.
+// Force-include it: g++ -include Benchmarks/LinuxCompat.h ...
+#ifndef _MSC_VER
+#define __int64 long long
+#include <cstring>
+#endif
@@ -0,0 +1,223 @@
+#include "BenchmarkSupport.h"
+#include "CursorBenchmarks.h"
+#include "YcsbWorkload.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+	void PrintUsage() {
+		fprintf(stderr,
+			"usage: native-benchmarks [options]\n"
+			"       native-benchmarks ycsb [ycsb options]\n"
+			"  --home DIR               directory for the databases, default bench-home\n"
+			"  --rows N                 rows per table, default 100000\n"
+			"  --key-sizes A,B          key sizes in bytes, at least 8, default 16,64\n"
+			"  --value-sizes A,B        value sizes in bytes, default 100,1000\n"
+			"  --cache-sizes A,B        WiredTiger cache sizes, default 64MB,1GB\n"
+			"  --table-configs A|B      table configs separated by |, default \"|leaf_page_max=4KB|prefix_compression=true\"\n"
+			"  --benchmarks A,B         insert always runs, then any of search,search_near,scan_forward,scan_backward,total_count\n"
+			"  --seed N                 seed of the key order, default 1\n"
+			"  --latency                track latencies in NativeCursor and report p50Ns, p99Ns and maxNs\n"
+			"ycsb options:\n"
+			"  --home DIR               directory for the databases, default ycsb-home\n"
+			"  --in-memory              use in_memory=true databases\n"
+			"  --cache-size SIZE        WiredTiger cache size, default 256MB\n"
+			"  --connection-config C    appended to the wiredtiger_open config\n"
+			"  --table-config C         appended to key_format=u,value_format=u\n"
+			"  --records N              records loaded before a workload runs, default 100000\n"
+			"  --operations N           operations of every thread count, default 100000\n"
+			"  --key-size N             key size in bytes, at least 8, default 24\n"
+			"  --value-size N           value size in bytes, default 1000\n"
+			"  --max-scan-length N      scans read 1 to N rows, default 100\n"
+			"  --threads A,B            thread counts to run, default 1,2,4,8\n"
+			"  --max-threads N          runs 1, 2, 4 and so on up to N threads\n"
+			"  --workloads A,B          core workloads A to F, default all of them\n"
+			"  --mix read=R,update=U,insert=I,scan=S,rmw=M  runs a custom mix instead\n"
+			"  --distribution D         uniform, zipfian or latest instead of the workload default\n"
+			"  --seed N                 seed of the key choice, default 1\n"
+			"Results are printed to stdout as JSON lines.\n");
+	}
+
+	std::vector<int> ParseSizes(const std::string& text) {
+		std::vector<std::string> parts = Split(text, ',');
+		std::vector<int> result;
+		for (size_t i = 0; i < parts.size(); i++)
+			result.push_back((int)ParseSize(parts[i]));
+		return result;
+	}
+
+	YcsbMix ParseMix(const std::string& text) {
+		YcsbMix mix = { 0, 0, 0, 0, 0 };
+		std::vector<std::string> parts = Split(text, ',');
+		for (size_t i = 0; i < parts.size(); i++) {
+			std::vector<std::string> pair = Split(parts[i], '=');
+			double share = pair.size() == 2 ? atof(pair[1].c_str()) : -1;
+			if (share < 0)
+				throw NativeWiredTigerApiException(EINVAL, "bad mix " + parts[i]);
+			if (pair[0] == "read")
+				mix.read = share;
+			else if (pair[0] == "update")
+				mix.update = share;
+			else if (pair[0] == "insert")
+				mix.insert = share;
+			else if (pair[0] == "scan")
+				mix.scan = share;
+			else if (pair[0] == "rmw")
+				mix.readModifyWrite = share;
+			else
+				throw NativeWiredTigerApiException(EINVAL, "bad mix " + parts[i]);
+		}
+		if (mix.read + mix.update + mix.insert + mix.scan + mix.readModifyWrite <= 0)
+			throw NativeWiredTigerApiException(EINVAL, "empty mix " + text);
+		return mix;
+	}
+
+	int Ycsb(int argc, char** argv) {
+		YcsbOptions options;
+		options.home = "ycsb-home";
+		options.inMemory = false;
+		options.cacheSize = "256MB";
+		options.records = 100000;
+		options.operations = 100000;
+		options.keySize = 24;
+		options.valueSize = 1000;
+		options.maxScanLength = 100;
+		options.threads = ParseSizes("1,2,4,8");
+		options.workloads = Split("A,B,C,D,E,F", ',');
+		options.distributionSet = false;
+		options.distribution = YcsbZipfian;
+		options.seed = 1;
+		for (int i = 0; i < argc; i++) {
+			std::string name = argv[i];
+			if (name == "--in-memory") {
+				options.inMemory = true;
+				continue;
+			}
+			if (i + 1 >= argc) {
+				PrintUsage();
+				return 2;
+			}
+			std::string value = argv[++i];
+			if (name == "--home")
+				options.home = value;
+			else if (name == "--cache-size")
+				options.cacheSize = value;
+			else if (name == "--connection-config")
+				options.connectionConfig = value;
+			else if (name == "--table-config")
+				options.tableConfig = value;
+			else if (name == "--records")
+				options.records = ParseSize(value);
+			else if (name == "--operations")
+				options.operations = ParseSize(value);
+			else if (name == "--key-size")
+				options.keySize = (int)ParseSize(value);
+			else if (name == "--value-size")
+				options.valueSize = (int)ParseSize(value);
+			else if (name == "--max-scan-length")
+				options.maxScanLength = (int)ParseSize(value);
+			else if (name == "--threads")
+				options.threads = ParseSizes(value);
+			else if (name == "--max-threads") {
+				int maxThreads = (int)ParseSize(value);
+				options.threads.clear();
+				for (int threads = 1; threads < maxThreads; threads *= 2)
+					options.threads.push_back(threads);
+				options.threads.push_back(maxThreads);
+			}
+			else if (name == "--workloads")
+				options.workloads = Split(value, ',');
+			else if (name == "--mix") {
+				options.mix = ParseMix(value);
+				options.workloads = Split("custom", ',');
+			}
+			else if (name == "--distribution") {
+				options.distribution = ParseYcsbDistribution(value);
+				options.distributionSet = true;
+			}
+			else if (name == "--seed")
+				options.seed = (unsigned int)strtoul(value.c_str(), nullptr, 10);
+			else {
+				PrintUsage();
+				return 2;
+			}
+		}
+		if (options.keySize < 8 || options.valueSize < 1 || options.records < 2 || options.maxScanLength < 1) {
+			fprintf(stderr, "keys need at least 8 bytes, values 1 byte, scans 1 row and there must be 2 records\n");
+			return 2;
+		}
+		for (size_t i = 0; i < options.threads.size(); i++)
+			if (options.threads[i] < 1) {
+				fprintf(stderr, "thread counts must be positive\n");
+				return 2;
+			}
+		RunYcsb(options);
+		return 0;
+	}
+}
+
+int main(int argc, char** argv) {
+	if (argc > 1 && std::string(argv[1]) == "ycsb") {
+		try {
+			return Ycsb(argc - 2, argv + 2);
+		}
+		catch (const NativeWiredTigerApiException& e) {
+			fprintf(stderr, "%s failed: %d %s\n", e.ApiName().c_str(), e.ErrorCode(), wiredtiger_strerror(e.ErrorCode()));
+			return 1;
+		}
+	}
+	CursorBenchmarkOptions options;
+	options.home = "bench-home";
+	options.rows = 100000;
+	options.keySizes = ParseSizes("16,64");
+	options.valueSizes = ParseSizes("100,1000");
+	options.cacheSizes = Split("64MB,1GB", ',');
+	options.tableConfigs = Split("|leaf_page_max=4KB|prefix_compression=true", '|');
+	options.seed = 1;
+	for (int i = 1; i < argc; i++) {
+		std::string name = argv[i];
+		if (name == "--latency") {
+			SetLatencyTracking(true);
+			continue;
+		}
+		if (i + 1 >= argc) {
+			PrintUsage();
+			return 2;
+		}
+		std::string value = argv[++i];
+		if (name == "--home")
+			options.home = value;
+		else if (name == "--rows")
+			options.rows = ParseSize(value);
+		else if (name == "--key-sizes")
+			options.keySizes = ParseSizes(value);
+		else if (name == "--value-sizes")
+			options.valueSizes = ParseSizes(value);
+		else if (name == "--cache-sizes")
+			options.cacheSizes = Split(value, ',');
+		else if (name == "--table-configs")
+			options.tableConfigs = Split(value, '|');
+		else if (name == "--benchmarks")
+			options.benchmarks = Split(value, ',');
+		else if (name == "--seed")
+			options.seed = (unsigned int)strtoul(value.c_str(), nullptr, 10);
+		else {
+			PrintUsage();
+			return 2;
+		}
+	}
+	for (size_t i = 0; i < options.keySizes.size(); i++)
+		if (options.keySizes[i] < 8) {
+			fprintf(stderr, "key sizes must be at least 8 bytes\n");
+			return 2;
+		}
+	try {
+		RunCursorBenchmarks(options);
+	}
+	catch (const NativeWiredTigerApiException& e) {
+		fprintf(stderr, "%s failed: %d %s\n", e.ApiName().c_str(), e.ErrorCode(), wiredtiger_strerror(e.ErrorCode()));
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,506 @@
+#include "YcsbWorkload.h"
+#include "BenchmarkSupport.h"
+#include "NativeClock.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace {
+	enum YcsbOp {
+		YcsbRead,
+		YcsbUpdate,
+		YcsbInsert,
+		YcsbScan,
+		YcsbReadModifyWrite,
+		YcsbOpCount
+	};
+
+	const char* const opNames[YcsbOpCount] = { "read", "update", "insert", "scan", "readModifyWrite" };
+
+	// Attempts of an update or insert that keeps failing with WT_ROLLBACK
+	const int writeAttempts = 100;
+
+	struct Workload {
+		std::string name;
+		YcsbMix mix;
+		YcsbDistribution distribution;
+	};
+
+	Workload CoreWorkload(const std::string& name) {
+		Workload workload;
+		workload.name = name;
+		YcsbMix none = { 0, 0, 0, 0, 0 };
+		workload.mix = none;
+		workload.distribution = YcsbZipfian;
+		if (name == "A") {
+			workload.mix.read = 0.5;
+			workload.mix.update = 0.5;
+		}
+		else if (name == "B") {
+			workload.mix.read = 0.95;
+			workload.mix.update = 0.05;
+		}
+		else if (name == "C")
+			workload.mix.read = 1;
+		else if (name == "D") {
+			workload.mix.read = 0.95;
+			workload.mix.insert = 0.05;
+			workload.distribution = YcsbLatest;
+		}
+		else if (name == "E") {
+			workload.mix.scan = 0.95;
+			workload.mix.insert = 0.05;
+		}
+		else if (name == "F") {
+			workload.mix.read = 0.5;
+			workload.mix.readModifyWrite = 0.5;
+		}
+		else
+			throw NativeWiredTigerApiException(EINVAL, "unknown YCSB workload " + name);
+		return workload;
+	}
+
+	// Zipfian generator of Gray et al., "Quickly generating billion-record synthetic databases",
+	// as used by YCSB. Small values are the most popular.
+	class Zipfian {
+	public:
+		Zipfian(__int64 items, double theta) : items_(items), theta_(theta) {
+			double zeta2 = Zeta(2);
+			zetan_ = Zeta(items);
+			alpha_ = 1 / (1 - theta);
+			eta_ = (1 - pow(2.0 / items, 1 - theta)) / (1 - zeta2 / zetan_);
+		}
+
+		__int64 Next(double u) const {
+			double uz = u * zetan_;
+			if (uz < 1)
+				return 0;
+			if (uz < 1 + pow(0.5, theta_))
+				return 1;
+			__int64 value = (__int64)(items_ * pow(eta_ * u - eta_ + 1, alpha_));
+			return value < items_ ? value : items_ - 1;
+		}
+
+	private:
+		__int64 items_;
+		double theta_;
+		double zetan_;
+		double alpha_;
+		double eta_;
+
+		double Zeta(__int64 n) const {
+			double sum = 0;
+			for (__int64 i = 0; i < n; i++)
+				sum += 1 / pow((double)(i + 1), theta_);
+			return sum;
+		}
+	};
+
+	// Records are inserted in index order, hashing spreads them over the key space like YCSB does
+	void FillRecordKey(__int64 index, Byte* key, int keySize) {
+		unsigned __int64 hash = 14695981039346656037ull;
+		for (int i = 0; i < 8; i++) {
+			hash ^= (Byte)(index >> (8 * i));
+			hash *= 1099511628211ull;
+		}
+		FillKey((__int64)hash, key, keySize);
+	}
+
+	struct Shared {
+		const YcsbOptions* options;
+		WT_CONNECTION* connection;
+		std::string uri;
+		Workload workload;
+		const Zipfian* zipfian;
+		// index of the next record to insert and the number of records readers may ask for
+		std::atomic<__int64> nextInsert;
+		std::atomic<__int64> inserted;
+		std::atomic<int> ready;
+		std::atomic<bool> start;
+		std::mutex errorMutex;
+		std::string error;
+	};
+
+	struct ThreadResult {
+		std::vector<__int64> latencies[YcsbOpCount];
+		__int64 rollbacks;
+		__int64 notFound;
+	};
+
+	class Worker {
+	public:
+		Worker(Shared& shared, unsigned int seed) :
+			shared_(shared),
+			options_(*shared.options),
+			random_(seed),
+			key_(options_.keySize),
+			value_(options_.valueSize),
+			checksum_(0) {
+			session_ = OpenSession(shared.connection);
+			cursor_.reset(OpenNativeCursor(session_, shared.uri.c_str(), nullptr));
+			result_.rollbacks = 0;
+			result_.notFound = 0;
+		}
+
+		~Worker() {
+			cursor_.reset();
+			session_->close(session_, nullptr);
+		}
+
+		const ThreadResult& Result() const {
+			return result_;
+		}
+
+		void Load(__int64 from, __int64 to) {
+			for (__int64 i = from; i < to; i++)
+				Write(i);
+		}
+
+		void Run(__int64 operations) {
+			const YcsbMix& mix = shared_.workload.mix;
+			double total = mix.read + mix.update + mix.insert + mix.scan + mix.readModifyWrite;
+			double thresholds[YcsbOpCount] = {
+				mix.read / total,
+				(mix.read + mix.update) / total,
+				(mix.read + mix.update + mix.insert) / total,
+				(mix.read + mix.update + mix.insert + mix.scan) / total,
+				1
+			};
+			for (int op = 0; op < YcsbOpCount; op++)
+				result_.latencies[op].reserve((size_t)operations);
+			for (__int64 i = 0; i < operations; i++) {
+				double choice = Uniform();
+				YcsbOp op = YcsbRead;
+				while (op < YcsbReadModifyWrite && choice >= thresholds[op])
+					op = (YcsbOp)(op + 1);
+				__int64 start = NativeClockTicks();
+				switch (op) {
+				case YcsbRead:
+					Read(ChooseRecord());
+					break;
+				case YcsbUpdate:
+					Write(ChooseRecord());
+					break;
+				case YcsbInsert:
+					Insert();
+					break;
+				case YcsbScan:
+					Scan(ChooseRecord());
+					break;
+				default:
+					ReadModifyWrite(ChooseRecord());
+					break;
+				}
+				result_.latencies[op].push_back(NativeClockTicks() - start);
+			}
+		}
+
+	private:
+		Shared& shared_;
+		const YcsbOptions& options_;
+		std::mt19937_64 random_;
+		WT_SESSION* session_;
+		std::unique_ptr<NativeCursor> cursor_;
+		std::vector<Byte> key_;
+		std::vector<Byte> value_;
+		size_t checksum_;
+		ThreadResult result_;
+
+		double Uniform() {
+			return std::uniform_real_distribution<double>(0, 1)(random_);
+		}
+
+		__int64 ChooseRecord() {
+			__int64 inserted = shared_.inserted.load(std::memory_order_acquire);
+			switch (shared_.workload.distribution) {
+			case YcsbUniform:
+				return std::uniform_int_distribution<__int64>(0, inserted - 1)(random_);
+			case YcsbZipfian:
+				return shared_.zipfian->Next(Uniform());
+			default: {
+				__int64 record = inserted - 1 - shared_.zipfian->Next(Uniform());
+				return record > 0 ? record : 0;
+			}
+			}
+		}
+
+		void Read(__int64 record) {
+			FillRecordKey(record, key_.data(), options_.keySize);
+			WT_ITEM value;
+			if (!cursor_->Get(key_.data(), options_.keySize, &value))
+				result_.notFound++;
+			cursor_->Reset();
+		}
+
+		void Write(__int64 record) {
+			FillRecordKey(record, key_.data(), options_.keySize);
+			FillValue((__int64)random_(), value_.data(), options_.valueSize);
+			for (int attempt = 0;; attempt++) {
+				int r = cursor_->TryInsert(key_.data(), options_.keySize, value_.data(), options_.valueSize);
+				if (r == 0)
+					return;
+				if (r != WT_ROLLBACK || attempt + 1 >= writeAttempts)
+					throw NativeWiredTigerApiException(r, "cursor->insert");
+				result_.rollbacks++;
+			}
+		}
+
+		void Insert() {
+			__int64 record = shared_.nextInsert++;
+			Write(record);
+			// readers may ask for records up to the highest one inserted, a few of them may still be in flight
+			__int64 inserted = shared_.inserted.load();
+			while (inserted < record + 1 && !shared_.inserted.compare_exchange_weak(inserted, record + 1)) {
+			}
+		}
+
+		void Scan(__int64 record) {
+			FillRecordKey(record, key_.data(), options_.keySize);
+			int length = std::uniform_int_distribution<int>(1, options_.maxScanLength)(random_);
+			int rows = 0;
+			if (cursor_->IterationBegin(key_.data(), options_.keySize, true, nullptr, 0, false, Ascending, false))
+				do {
+					// touch the row as a reader would
+					checksum_ += cursor_->ValueView().size;
+					rows++;
+				} while (rows < length && cursor_->IterationMove());
+			cursor_->Reset();
+			if (rows == 0)
+				result_.notFound++;
+		}
+
+		static int ReadModifyWriteBody(void* context) {
+			Worker* worker = static_cast<Worker*>(context);
+			try {
+				WT_ITEM value;
+				if (!worker->cursor_->Get(worker->key_.data(), worker->options_.keySize, &value))
+					return WT_NOTFOUND;
+				size_t size = std::min(value.size, worker->value_.size());
+				memcpy(worker->value_.data(), value.data, size);
+				worker->value_[0]++;
+				return worker->cursor_->TryInsert(worker->key_.data(), worker->options_.keySize,
+					worker->value_.data(), (int)size);
+			}
+			catch (const NativeWiredTigerApiException& e) {
+				return e.ErrorCode();
+			}
+		}
+
+		void ReadModifyWrite(__int64 record) {
+			FillRecordKey(record, key_.data(), options_.keySize);
+			int attempts;
+			int r = RunTransaction(session_, nullptr, nullptr, &Worker::ReadModifyWriteBody, this, writeAttempts, &attempts);
+			result_.rollbacks += attempts - 1;
+			cursor_->Reset();
+			if (r == WT_NOTFOUND)
+				result_.notFound++;
+			else if (r != 0)
+				throw NativeWiredTigerApiException(r, "read-modify-write transaction");
+		}
+	};
+
+	// Runs body on threads workers started together, returns the seconds from start until all finished
+	template <class Body>
+	double RunThreads(Shared& shared, std::vector<std::unique_ptr<Worker>>& workers, Body body) {
+		shared.ready = 0;
+		shared.start = false;
+		std::vector<std::thread> threads;
+		for (size_t i = 0; i < workers.size(); i++) {
+			Worker* worker = workers[i].get();
+			threads.push_back(std::thread([&shared, worker, body, i] {
+				shared.ready++;
+				while (!shared.start.load())
+					std::this_thread::yield();
+				try {
+					body(worker, i);
+				}
+				catch (const NativeWiredTigerApiException& e) {
+					std::lock_guard<std::mutex> lock(shared.errorMutex);
+					if (shared.error.empty())
+						shared.error = e.ApiName() + ": " + wiredtiger_strerror(e.ErrorCode());
+				}
+			}));
+		}
+		while (shared.ready.load() < (int)workers.size())
+			std::this_thread::yield();
+		Stopwatch stopwatch;
+		shared.start = true;
+		for (size_t i = 0; i < threads.size(); i++)
+			threads[i].join();
+		double seconds = stopwatch.Seconds();
+		if (!shared.error.empty())
+			throw NativeWiredTigerApiException(WT_ERROR, shared.error);
+		return seconds;
+	}
+
+	const int cacheStatisticKeys[] = {
+		WT_STAT_CONN_CACHE_BYTES_INUSE,
+		WT_STAT_CONN_CACHE_BYTES_MAX,
+		WT_STAT_CONN_CACHE_PAGES_REQUESTED,
+		WT_STAT_CONN_CACHE_READ,
+		WT_STAT_CONN_CACHE_WRITE,
+		WT_STAT_CONN_CACHE_EVICTION_CLEAN,
+		WT_STAT_CONN_CACHE_EVICTION_DIRTY,
+		WT_STAT_CONN_TXN_ROLLBACK
+	};
+	const int cacheStatisticCount = sizeof(cacheStatisticKeys) / sizeof(cacheStatisticKeys[0]);
+
+	void ReadCacheStatistics(WT_SESSION* session, __int64* values) {
+		ReadStatistics(session, "", nullptr, cacheStatisticKeys, cacheStatisticCount, values);
+	}
+
+	void AddCacheStatistics(JsonLine& line, const __int64* before, const __int64* after) {
+		line.Add("cacheBytesInUse", after[0])
+			.Add("cacheBytesMax", after[1])
+			.Add("cachePagesRequested", after[2] - before[2])
+			.Add("cachePagesRead", after[3] - before[3])
+			.Add("cachePagesWritten", after[4] - before[4])
+			.Add("cachePagesEvicted", after[5] - before[5] + after[6] - before[6])
+			.Add("transactionRollbacks", after[7] - before[7]);
+	}
+
+	__int64 Percentile(const std::vector<__int64>& sorted, double percentile) {
+		size_t index = (size_t)ceil(sorted.size() * percentile / 100);
+		return sorted[index > 0 ? index - 1 : 0];
+	}
+
+	void AddLatencies(JsonLine& line, std::vector<std::unique_ptr<Worker>>& workers) {
+		double nanosecondsPerTick = 1e9 / NativeClockFrequency();
+		for (int op = 0; op < YcsbOpCount; op++) {
+			std::vector<__int64> latencies;
+			for (size_t i = 0; i < workers.size(); i++) {
+				const std::vector<__int64>& source = workers[i]->Result().latencies[op];
+				latencies.insert(latencies.end(), source.begin(), source.end());
+			}
+			if (latencies.empty())
+				continue;
+			std::sort(latencies.begin(), latencies.end());
+			std::string name = opNames[op];
+			line.Add((name + "Count").c_str(), (__int64)latencies.size())
+				.Add((name + "P50Ns").c_str(), (__int64)(Percentile(latencies, 50) * nanosecondsPerTick))
+				.Add((name + "P95Ns").c_str(), (__int64)(Percentile(latencies, 95) * nanosecondsPerTick))
+				.Add((name + "P99Ns").c_str(), (__int64)(Percentile(latencies, 99) * nanosecondsPerTick))
+				.Add((name + "MaxNs").c_str(), (__int64)(latencies.back() * nanosecondsPerTick));
+		}
+	}
+
+	void RunWorkload(const YcsbOptions& options, const Workload& workload, int number) {
+		std::string home = options.home + "/ycsb" + std::to_string(number);
+		MakeDirectory(home);
+		int maxThreads = *std::max_element(options.threads.begin(), options.threads.end());
+		std::string config = "create,statistics=(fast),cache_size=" + options.cacheSize +
+			",session_max=" + std::to_string(maxThreads + 10) +
+			(options.inMemory ? ",in_memory=true" : ",log=(enabled=false)");
+		if (!options.connectionConfig.empty())
+			config += "," + options.connectionConfig;
+		WT_CONNECTION* connection = OpenConnection(home, config);
+		try {
+			Zipfian zipfian(options.records, 0.99);
+			Shared shared;
+			shared.options = &options;
+			shared.connection = connection;
+			shared.uri = "table:ycsb";
+			shared.workload = workload;
+			shared.zipfian = &zipfian;
+			shared.nextInsert = options.records;
+			shared.inserted = options.records;
+			WT_SESSION* session = OpenSession(connection);
+			std::string tableConfig = "key_format=u,value_format=u";
+			if (!options.tableConfig.empty())
+				tableConfig += "," + options.tableConfig;
+			Check(session->create(session, shared.uri.c_str(), tableConfig.c_str()), "session->create");
+
+			std::vector<std::unique_ptr<Worker>> workers;
+			for (int i = 0; i < maxThreads; i++)
+				workers.push_back(std::unique_ptr<Worker>(new Worker(shared, options.seed + i)));
+			__int64 before[cacheStatisticCount];
+			__int64 after[cacheStatisticCount];
+			ReadCacheStatistics(session, before);
+			__int64 records = options.records;
+			double seconds = RunThreads(shared, workers, [records, maxThreads](Worker* worker, size_t i) {
+				worker->Load(records * i / maxThreads, records * (i + 1) / maxThreads);
+			});
+			ReadCacheStatistics(session, after);
+			JsonLine load;
+			load.Add("phase", "load")
+				.Add("workload", workload.name)
+				.Add("threads", maxThreads)
+				.Add("records", records)
+				.Add("seconds", seconds)
+				.Add("opsPerSecond", records / seconds);
+			AddCacheStatistics(load, before, after);
+			load.Print();
+			workers.clear();
+
+			for (size_t t = 0; t < options.threads.size(); t++) {
+				int threads = options.threads[t];
+				for (int i = 0; i < threads; i++)
+					workers.push_back(std::unique_ptr<Worker>(new Worker(shared, options.seed + 1000 * (unsigned int)(t + 1) + i)));
+				__int64 operations = options.operations;
+				ReadCacheStatistics(session, before);
+				seconds = RunThreads(shared, workers, [operations, threads](Worker* worker, size_t i) {
+					worker->Run(operations * (i + 1) / threads - operations * i / threads);
+				});
+				ReadCacheStatistics(session, after);
+				__int64 rollbacks = 0;
+				__int64 notFound = 0;
+				for (size_t i = 0; i < workers.size(); i++) {
+					rollbacks += workers[i]->Result().rollbacks;
+					notFound += workers[i]->Result().notFound;
+				}
+				static const char* const distributionNames[] = { "uniform", "zipfian", "latest" };
+				JsonLine line;
+				line.Add("phase", "run")
+					.Add("workload", workload.name)
+					.Add("distribution", distributionNames[workload.distribution])
+					.Add("threads", threads)
+					.Add("records", shared.inserted.load())
+					.Add("operations", operations)
+					.Add("seconds", seconds)
+					.Add("opsPerSecond", operations / seconds)
+					.Add("rollbacks", rollbacks)
+					.Add("notFound", notFound);
+				AddLatencies(line, workers);
+				AddCacheStatistics(line, before, after);
+				line.Print();
+				workers.clear();
+			}
+		}
+		catch (...) {
+			connection->close(connection, nullptr);
+			throw;
+		}
+		connection->close(connection, nullptr);
+	}
+}
+
+YcsbDistribution ParseYcsbDistribution(const std::string& name) {
+	if (name == "uniform")
+		return YcsbUniform;
+	if (name == "zipfian")
+		return YcsbZipfian;
+	if (name == "latest")
+		return YcsbLatest;
+	throw NativeWiredTigerApiException(EINVAL, "unknown distribution " + name);
+}
+
+void RunYcsb(const YcsbOptions& options) {
+	MakeDirectory(options.home);
+	for (size_t i = 0; i < options.workloads.size(); i++) {
+		Workload workload;
+		if (options.workloads[i] == "custom") {
+			workload.name = "custom";
+			workload.mix = options.mix;
+			workload.distribution = YcsbZipfian;
+		}
+		else
+			workload = CoreWorkload(options.workloads[i]);
+		if (options.distributionSet)
+			workload.distribution = options.distribution;
+		RunWorkload(options, workload, (int)i);
+	}
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <string>
+#include <vector>
+
+enum YcsbDistribution {
+	YcsbUniform,
+	YcsbZipfian,
+	// zipfian over the most recently inserted records
+	YcsbLatest
+};
+
+// Shares of operation types, normalized by their sum
+struct YcsbMix {
+	double read;
+	double update;
+	double insert;
+	double scan;
+	double readModifyWrite;
+};
+
+struct YcsbOptions {
+	std::string home;
+	bool inMemory;
+	std::string cacheSize;
+	// Appended to the wiredtiger_open and create configs
+	std::string connectionConfig;
+	std::string tableConfig;
+	__int64 records;
+	// Operations of every point of the sweep, split between its threads
+	__int64 operations;
+	int keySize;
+	int valueSize;
+	int maxScanLength;
+	std::vector<int> threads;
+	// Letters of the core workloads A to F, or "custom" for mix
+	std::vector<std::string> workloads;
+	YcsbMix mix;
+	// Overrides the distribution of the core workloads when set
+	bool distributionSet;
+	YcsbDistribution distribution;
+	unsigned int seed;
+};
+
+YcsbDistribution ParseYcsbDistribution(const std::string& name);
+
+// For every workload loads a fresh database and runs the workload with each thread count, one session
+// and NativeCursor per thread. Prints a JSON line per load and per point with throughput, latency
+// percentiles by operation type, rollbacks and cache statistics.
+void RunYcsb(const YcsbOptions& options);
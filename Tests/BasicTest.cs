@@ -1,9 +1,12 @@
 ﻿using System;
+using System.Collections.Generic;
+using System.Diagnostics;
 using System.Globalization;
 using System.IO;
 using System.Linq;
 using System.Reflection;
 using System.Text;
+using System.Threading.Tasks;
 using NUnit.Framework;
 using WiredTigerNet;
 
@@ -130,6 +133,74 @@ namespace Tests
 			}
 		}
 
+		[Test]
+		public void BulkLoaderSortsAndSpillsRuns()
+		{
+			using (var connection = Connection.Open(testDirectory, "create", null))
+			using (var session = connection.OpenSession())
+			{
+				session.Create("table:test", null);
+				var tempDirectory = Path.Combine(testDirectory, "bulkTemp");
+				Directory.CreateDirectory(tempDirectory);
+				using (var loader = session.OpenBulkLoader("table:test", tempDirectory, 16, 2))
+				{
+					loader.Add("c".B(), "3".B());
+					loader.Add("a".B(), "1".B());
+					loader.Add("d".B(), "4".B());
+					loader.Add("b".B(), "2".B());
+					loader.Add("a".B(), "11".B());
+					Assert.That(loader.Complete(), Is.EqualTo(4));
+				}
+				Assert.That(Directory.GetFiles(tempDirectory), Is.Empty);
+				using (var cursor = session.OpenCursor("table:test"))
+					cursor.AssertAllKeysAndValues("a->11", "b->2", "c->3", "d->4");
+			}
+		}
+
+		[Test]
+		public void BulkLoaderStoresNullValueAsEmpty()
+		{
+			using (var connection = Connection.Open(testDirectory, "create", null))
+			using (var session = connection.OpenSession())
+			{
+				session.Create("table:test", null);
+				var tempDirectory = Path.Combine(testDirectory, "bulkTemp");
+				Directory.CreateDirectory(tempDirectory);
+				using (var loader = session.OpenBulkLoader("table:test", tempDirectory, 16, 2))
+				{
+					loader.Add("a".B(), "1".B());
+					loader.Add("b".B(), null);
+					Assert.That(loader.Complete(), Is.EqualTo(2));
+				}
+				using (var cursor = session.OpenCursor("table:test"))
+					cursor.AssertAllKeysAndValues("a->1", "b->");
+			}
+		}
+
+		[Test]
+		public void DisposingSessionClosesBulkLoader()
+		{
+			using (var connection = Connection.Open(testDirectory, "create", null))
+			{
+				var tempDirectory = Path.Combine(testDirectory, "bulkTemp");
+				Directory.CreateDirectory(tempDirectory);
+				BulkLoader loader;
+				using (var session = connection.OpenSession())
+				{
+					session.Create("table:test", null);
+					loader = session.OpenBulkLoader("table:test", tempDirectory, 1, 2);
+					loader.Add("b".B(), "2".B());
+					loader.Add("a".B(), "1".B());
+					loader.Add("c".B(), "3".B());
+				}
+				Assert.That(Directory.GetFiles(tempDirectory), Is.Empty);
+				loader.Dispose();
+				using (var session = connection.OpenSession())
+				using (var cursor = session.OpenCursor("table:test"))
+					cursor.AssertAllKeysAndValues();
+			}
+		}
+
 		[Test]
 		public void SimpleWithTran()
 		{
@@ -156,6 +227,42 @@ namespace Tests
 			}
 		}
 
+		[Test]
+		public void TransactionOptions()
+		{
+			using (var connection = Connection.Open(testDirectory, "create,log=(enabled=true)", null))
+			using (var session = connection.OpenSession())
+			{
+				session.Create("table:test", null);
+				var beginOptions = new TransactionOptions
+				{
+					Isolation = IsolationLevel.Snapshot,
+					Sync = false,
+					Priority = 10,
+					Name = "test"
+				};
+				var commitOptions = new CommitOptions {Sync = CommitSync.Off};
+				session.BeginTran(beginOptions);
+				using (var cursor = session.OpenCursor("table:test"))
+					cursor.Insert("a", "k");
+				session.CommitTran(commitOptions);
+				session.TransactionSync(null);
+
+				beginOptions.Isolation = IsolationLevel.ReadCommitted;
+				session.BeginTran(beginOptions);
+				using (var cursor = session.OpenCursor("table:test"))
+					cursor.Insert("b", "k");
+				session.CommitTran(commitOptions);
+
+				beginOptions.Priority = 1000;
+				var exception = Assert.Throws<WiredTigerApiException>(() => session.BeginTran(beginOptions));
+				Assert.That(exception.ApiName, Is.EqualTo("session->begin_transaction"));
+
+				using (var cursor = session.OpenCursor("table:test"))
+					cursor.AssertAllKeysAndValues("a->k", "b->k");
+			}
+		}
+
 		[Test]
 		public void SessionCreateConfigParameterIsNullable()
 		{
@@ -212,6 +319,70 @@ namespace Tests
 			Assert.That(loggedEvent.message, Is.StringContaining(testDirectory));
 		}
 
+		[Test]
+		public void BufferedEventHandlerDeliversEventsOnOpenFailure()
+		{
+			var eventHandler = new LoggingEventHandler();
+			var exception =
+				Assert.Throws<WiredTigerApiException>(() => Connection.Open(Path.Combine(testDirectory, "inexistentFolder"),
+					"", null, eventHandler, 16));
+			Assert.That(exception.ErrorCode, Is.EqualTo(2));
+			Assert.That(eventHandler.loggedEvents.Count, Is.EqualTo(1));
+			var loggedEvent = (LoggingEventHandler.ErrorEvent) eventHandler.loggedEvents.Single();
+			Assert.That(loggedEvent.errorCode, Is.EqualTo(2));
+			Assert.That(loggedEvent.message, Is.StringContaining(testDirectory));
+		}
+
+		[Test]
+		public void BufferedEventHandler()
+		{
+			var eventHandler = new LoggingEventHandler();
+			using (var connection = Connection.Open(testDirectory, "create", null, eventHandler, 16))
+			using (var session = connection.OpenSession())
+			{
+				session.Create("table:test", "key_format=u,value_format=u,columns=(k,v)");
+				using (var cursor = session.OpenCursor("table:test"))
+					cursor.Insert("k".B(), "v".B());
+				var exception = Assert.Throws<WiredTigerApiException>(() => session.Create("table:invalid", "no_such_key=1"));
+				Assert.That(exception.ErrorCode, Is.EqualTo(22));
+				Assert.That(connection.DroppedErrors, Is.EqualTo(0));
+				Assert.That(connection.DroppedMessages, Is.EqualTo(0));
+			}
+			// closing the connection drains the buffer
+			var errors = eventHandler.loggedEvents.OfType<LoggingEventHandler.ErrorEvent>()
+				.Where(x => x.message.Contains("no_such_key"))
+				.ToArray();
+			Assert.That(errors.Length, Is.EqualTo(1));
+			Assert.That(errors[0].errorCode, Is.EqualTo(22));
+		}
+
+		[Test]
+		public void VerifyReportsProgress()
+		{
+			var eventHandler = new LoggingEventHandler();
+			using (var connection = Connection.Open(testDirectory, "create", null, eventHandler))
+			using (var session = connection.OpenSession())
+			{
+				session.Create("table:test", "key_format=u,value_format=u,columns=(k,v),leaf_page_max=512");
+				session.BeginTran();
+				using (var cursor = session.OpenCursor("table:test"))
+					for (var i = 0; i < 20000; i++)
+						cursor.Insert(i.ToString("D8").B(), "value".B());
+				session.CommitTran();
+				session.Checkpoint(null);
+				eventHandler.loggedEvents.Clear();
+				var stopwatch = Stopwatch.StartNew();
+				session.Verify("table:test", null);
+				stopwatch.Stop();
+				var progress = eventHandler.loggedEvents.OfType<LoggingEventHandler.ProgressEvent>().ToArray();
+				Assert.That(progress, Is.Not.Empty);
+				Assert.That(progress[0].operation, Is.StringContaining("verify"));
+				Assert.That(progress[0].progress, Is.GreaterThan(0));
+				// the first report passes, then at most one per elapsed second
+				Assert.That(progress.Length, Is.LessThanOrEqualTo(2 + (int) stopwatch.Elapsed.TotalSeconds));
+			}
+		}
+
 		[Test]
 		public void CheckKeyOnlyCursorSchema()
 		{
@@ -340,6 +511,694 @@ namespace Tests
 			}
 		}
 
+		[Test]
+		public void EstimateCount()
+		{
+			using (var connection = Connection.Open(testDirectory, "create", null))
+			using (var session = connection.OpenSession())
+			{
+				session.Create("table:test", "key_format=u,value_format=u,columns=(k,v)");
+
+				using (var cursor = session.OpenCursor("table:test"))
+				{
+					for (var i = 0; i < 200000; i++)
+						cursor.Insert(i.ToString("D6"), "v");
+				}
+
+				using (var cursor = session.OpenCursor("table:test"))
+				{
+					var small = cursor.EstimateCount(Range.Segment("000100".B(), "000199".B()), 0.1, 200000);
+					Assert.That(small.IsExact, Is.True);
+					Assert.That(small.Estimate, Is.EqualTo(100));
+					Assert.That(small.Lower, Is.EqualTo(100));
+					Assert.That(small.Upper, Is.EqualTo(100));
+
+					var half = cursor.EstimateCount(Range.RightOpenSegment("050000".B(), "150000".B()), 0.1, 200000);
+					Assert.That(half.IsExact, Is.False);
+					Assert.That(half.Lower, Is.LessThanOrEqualTo(half.Estimate));
+					Assert.That(half.Upper, Is.GreaterThanOrEqualTo(half.Estimate));
+					Assert.That(half.Estimate, Is.InRange(70000, 130000));
+
+					// without tree walk statistics the table size is unknown, so the range is counted
+					var counted = cursor.EstimateCount(Range.RightOpenSegment("050000".B(), "150000".B()), 0.1);
+					Assert.That(counted.IsExact, Is.True);
+					Assert.That(counted.Estimate, Is.EqualTo(100000));
+
+					Assert.Throws<ArgumentOutOfRangeException>(() => cursor.EstimateCount(Range.Line(), 0));
+				}
+			}
+		}
+
+		[TestCase(1, true)]
+		[TestCase(4, true)]
+		[TestCase(4, false)]
+		public void ParallelCountAndScan(int threads, bool ordered)
+		{
+			using (var connection = Connection.Open(testDirectory, "create", null))
+			{
+				using (var session = connection.OpenSession())
+				{
+					session.Create("table:test", "key_format=u,value_format=u,columns=(k,v)");
+					using (var cursor = session.OpenCursor("table:test"))
+						for (var i = 0; i < 10000; i++)
+							cursor.Insert(i.ToString("D5"), "v" + i);
+				}
+
+				var range = Range.RightOpenSegment("01000".B(), "09000".B());
+				Assert.That(connection.ParallelCount("table:test", range, threads), Is.EqualTo(8000));
+
+				var keys = new List<string>();
+				using (var scan = connection.OpenParallelScan("table:test", range, threads, ordered))
+				{
+					var batch = new KeyValueBatch(100);
+					while (scan.ReadBatch(batch) > 0)
+						for (var i = 0; i < batch.Count; i++)
+						{
+							var key = batch.GetKey(i).S();
+							Assert.That(batch.GetValue(i).S(), Is.EqualTo("v" + int.Parse(key)));
+							keys.Add(key);
+						}
+				}
+				var expected = Enumerable.Range(1000, 8000).Select(i => i.ToString("D5")).ToList();
+				if (ordered)
+					Assert.That(keys, Is.EqualTo(expected));
+				else
+					Assert.That(keys, Is.EquivalentTo(expected));
+			}
+		}
+
+		[Test]
+		public void GetSplitPoints()
+		{
+			using (var connection = Connection.Open(testDirectory, "create", null))
+			using (var session = connection.OpenSession())
+			{
+				session.Create("table:test", "key_format=u,value_format=u,columns=(k,v)");
+				using (var cursor = session.OpenCursor("table:test"))
+					for (var i = 0; i < 10000; i++)
+						cursor.Insert(i.ToString("D5"), "v");
+
+				var range = Range.PositiveRay("00000".B());
+				var parts = session.GetSplitPoints("table:test", range, 4);
+				Assert.That(parts.Length, Is.InRange(2, 4));
+				Assert.That(parts[0].Left.Value.Bytes, Is.EqualTo(range.Left.Value.Bytes));
+				Assert.That(parts[parts.Length - 1].Right.HasValue, Is.False);
+				using (var cursor = session.OpenCursor("table:test"))
+				{
+					var total = 0L;
+					for (var i = 0; i < parts.Length; i++)
+					{
+						if (i > 0)
+						{
+							Assert.That(parts[i].Left.Value.Bytes, Is.EqualTo(parts[i - 1].Right.Value.Bytes));
+							Assert.That(parts[i].Left.Value.Inclusive, Is.True);
+							Assert.That(parts[i - 1].Right.Value.Inclusive, Is.False);
+						}
+						var count = cursor.GetTotalCount(parts[i]);
+						Assert.That(count, Is.InRange(10000 / parts.Length / 3, 10000 / parts.Length * 3));
+						total += count;
+					}
+					Assert.That(total, Is.EqualTo(10000));
+				}
+
+				Assert.That(session.GetSplitPoints("table:test", Range.Segment("00005".B(), "00005".B()), 4).Length, Is.EqualTo(1));
+			}
+		}
+
+		[TestCase(Direction.Ascending)]
+		[TestCase(Direction.Descending)]
+		public void IterateMultipleRanges(Direction direction)
+		{
+			using (var connection = Connection.Open(testDirectory, "create", null))
+			using (var session = connection.OpenSession())
+			{
+				session.Create("table:test", "key_format=u,value_format=u,columns=(k,v)");
+				using (var cursor = session.OpenCursor("table:test"))
+				{
+					foreach (var key in new[] { "a1", "a2", "b1", "c1", "c2", "d1", "f1", "g1", "z1" })
+						cursor.Insert(key, "v");
+
+					var ranges = new[]
+					{
+						Range.Prefix("f".B()),
+						Range.Prefix("a".B()),
+						Range.Segment("c2".B(), "d1".B()),
+						Range.Interval("c1".B(), "c2".B()),
+						Range.PositiveRay("y".B()),
+						Range.Prefix("e".B())
+					};
+					var keys = new List<string>();
+					if (cursor.IterationBegin(ranges, direction))
+						do
+						{
+							keys.Add(cursor.GetKey().S());
+						} while (cursor.IterationMove());
+
+					var expected = new[] { "a1", "a2", "c2", "d1", "f1", "z1" };
+					Assert.That(keys, Is.EqualTo(direction == Direction.Ascending ? expected : expected.Reverse()));
+					Assert.That(cursor.IterationBegin(new[] { Range.Prefix("e".B()), Range.Empty() }, direction), Is.False);
+				}
+			}
+		}
+
+		[Test]
+		public void RangeSetAlgebra()
+		{
+			using (var a = new RangeSet(new[] { Range.Segment("f".B(), "h".B()), Range.Segment("b".B(), "d".B()), Range.Empty() }))
+			using (var b = new RangeSet(new[] { Range.Segment("c".B(), "e".B()), Range.Segment("e".B(), "g".B()) }))
+			using (var union = a.Union(b))
+			using (var intersection = a.Intersect(b))
+			using (var difference = a.Difference(b))
+			using (var complement = a.Complement())
+			{
+				Assert.That(a.Count, Is.EqualTo(2));
+				Assert.That(b.Count, Is.EqualTo(1));
+				Assert.That(union.Count, Is.EqualTo(1));
+				Assert.That(union[0].Left.Value.Bytes.S(), Is.EqualTo("b"));
+				Assert.That(union[0].Right.Value.Bytes.S(), Is.EqualTo("h"));
+				Assert.That(intersection.Count, Is.EqualTo(2));
+
+				Assert.That(difference.Count, Is.EqualTo(2));
+				Assert.That(difference[0].Right.Value.Inclusive, Is.False);
+				Assert.That(difference[1].Left.Value.Inclusive, Is.False);
+				Assert.That(difference.Contains("b".B()), Is.True);
+				Assert.That(difference.Contains("c".B()), Is.False);
+				Assert.That(difference.Contains("g".B()), Is.False);
+				Assert.That(difference.Contains("gg".B()), Is.True);
+
+				var gaps = complement.ToArray();
+				Assert.That(gaps.Length, Is.EqualTo(3));
+				Assert.That(gaps[0].Left.HasValue, Is.False);
+				Assert.That(gaps[2].Right.HasValue, Is.False);
+				Assert.That(complement.Contains("e".B()), Is.True);
+				Assert.That(complement.Contains("f".B()), Is.False);
+				Assert.That(complement.Union(a).Count, Is.EqualTo(1));
+				Assert.That(complement.Intersect(a).Count, Is.EqualTo(0));
+
+				using (var connection = Connection.Open(testDirectory, "create", null))
+				using (var session = connection.OpenSession())
+				{
+					session.Create("table:test", "key_format=u,value_format=u,columns=(k,v)");
+					using (var cursor = session.OpenCursor("table:test"))
+					{
+						foreach (var key in new[] { "a", "b", "c", "d", "e", "f", "g", "gg", "h", "i" })
+							cursor.Insert(key, "v");
+
+						Assert.That(cursor.GetTotalCount(difference), Is.EqualTo(3));
+						var keys = new List<string>();
+						if (cursor.IterationBegin(intersection, Direction.Descending))
+							do
+							{
+								keys.Add(cursor.GetKey().S());
+							} while (cursor.IterationMove());
+						Assert.That(keys, Is.EqualTo(new[] { "g", "f", "d", "c" }));
+					}
+				}
+			}
+		}
+
+		[Test]
+		public void ReadBatchResumesWhereItStopped()
+		{
+			using (var connection = Connection.Open(testDirectory, "create", null))
+			using (var session = connection.OpenSession())
+			{
+				session.Create("table:test", "key_format=u,value_format=u,columns=(k,v)");
+
+				using (var cursor = session.OpenCursor("table:test"))
+				{
+					cursor.Insert("a", "1");
+					cursor.Insert("b", "22");
+					cursor.Insert("c", "333");
+					cursor.Insert("d", "4444");
+					cursor.Insert("e", "55555");
+				}
+
+				using (var cursor = session.OpenCursor("table:test"))
+				{
+					var batch = new KeyValueBatch(2);
+					Assert.That(cursor.ReadBatch(Range.Segment("b".B(), "e".B()), Direction.Descending, batch), Is.EqualTo(2));
+					Assert.That(batch.GetKey(0).S(), Is.EqualTo("e"));
+					Assert.That(batch.GetValue(0).S(), Is.EqualTo("55555"));
+					Assert.That(batch.GetKey(1).S(), Is.EqualTo("d"));
+					Assert.That(batch.ValueLength(1), Is.EqualTo(4));
+					Assert.That(cursor.ReadBatch(batch), Is.EqualTo(2));
+					Assert.That(batch.GetKey(0).S(), Is.EqualTo("c"));
+					Assert.That(batch.GetKey(1).S(), Is.EqualTo("b"));
+					Assert.That(batch.GetValue(1).S(), Is.EqualTo("22"));
+					Assert.That(cursor.ReadBatch(batch), Is.EqualTo(0));
+					Assert.That(batch.Count, Is.EqualTo(0));
+
+					Assert.That(cursor.ReadBatch(Range.Segment("b".B(), "e".B()), Direction.Ascending, batch), Is.EqualTo(2));
+					Assert.That(cursor.IterationBegin(Range.PositiveRay("f".B()), Direction.Ascending), Is.False);
+					Assert.That(cursor.ReadBatch(batch), Is.EqualTo(0));
+					Assert.That(cursor.IterationBegin(Range.NegativeOpenRay("a".B()), Direction.Descending), Is.False);
+					Assert.That(cursor.ReadBatch(batch), Is.EqualTo(0));
+
+					var tinyBatch = new KeyValueBatch(1, 1);
+					Assert.That(cursor.ReadBatch(Range.PositiveRay("c".B()), Direction.Ascending, tinyBatch), Is.EqualTo(1));
+					Assert.That(tinyBatch.GetValue(0).S(), Is.EqualTo("333"));
+					Assert.That(tinyBatch.Buffer.Length, Is.GreaterThanOrEqualTo(4));
+				}
+			}
+		}
+
+		[Test]
+		public void KeyAndValueViews()
+		{
+			using (var connection = Connection.Open(testDirectory, "create", null))
+			using (var session = connection.OpenSession())
+			{
+				session.Create("table:test", "key_format=u,value_format=u,columns=(k,v)");
+
+				using (var cursor = session.OpenCursor("table:test"))
+				{
+					cursor.Insert("ab", "value");
+					Assert.That(cursor.Search("ab"));
+					var key = cursor.GetKeyView();
+					Assert.That(key.Length, Is.EqualTo(2));
+					Assert.That(key.SequenceEqual("ab".B()));
+					Assert.That(key.CompareTo("a".B()), Is.GreaterThan(0));
+					Assert.That(key.CompareTo("b".B()), Is.LessThan(0));
+					var value = cursor.GetValueView();
+					Assert.That(value.ToArray().S(), Is.EqualTo("value"));
+					var target = new byte[7];
+					value.CopyTo(target, 2);
+					Assert.That(target.Skip(2).ToArray().S(), Is.EqualTo("value"));
+				}
+			}
+		}
+
+		[Test]
+		public void GetKeyAndValueIntoCallerBuffer()
+		{
+			using (var connection = Connection.Open(testDirectory, "create", null))
+			using (var session = connection.OpenSession())
+			{
+				session.Create("table:test", "key_format=u,value_format=u,columns=(k,v)");
+
+				using (var cursor = session.OpenCursor("table:test"))
+				{
+					cursor.Insert("key", "value");
+					Assert.That(cursor.Search("key"));
+					var buffer = new byte[8];
+					Assert.That(cursor.GetKey(buffer, 1), Is.EqualTo(3));
+					Assert.That(buffer.Skip(1).Take(3).ToArray().S(), Is.EqualTo("key"));
+					Assert.That(cursor.GetValue(buffer, 4), Is.EqualTo(-5));
+					Assert.That(cursor.GetValue(buffer, 8), Is.EqualTo(-5));
+					Assert.That(cursor.GetValue(buffer, 3), Is.EqualTo(5));
+					Assert.That(buffer.Skip(3).ToArray().S(), Is.EqualTo("value"));
+				}
+			}
+		}
+
+		[Test]
+		public void TryGetAndMultiGet()
+		{
+			using (var connection = Connection.Open(testDirectory, "create", null))
+			using (var session = connection.OpenSession())
+			{
+				session.Create("table:test", "key_format=u,value_format=u,columns=(k,v)");
+
+				using (var cursor = session.OpenCursor("table:test"))
+				{
+					for (var c = 'a'; c <= 'z'; c += (char) 2)
+						cursor.Insert(c.ToString(), "v" + c);
+
+					byte[] value;
+					Assert.That(cursor.TryGet("c".B(), out value));
+					Assert.That(value.S(), Is.EqualTo("vc"));
+					Assert.That(cursor.TryGet("d".B(), out value), Is.False);
+					Assert.That(value, Is.Null);
+
+					var keys = new[] {"y", "b", "a", "zz", "c", "a", "0", "q"};
+					var values = cursor.MultiGet(keys.Select(x => x.B()).ToArray());
+					Assert.That(values.Select(x => x == null ? null : x.S()).ToArray(),
+						Is.EqualTo(new[] {"vy", null, "va", null, "vc", "va", null, "vq"}));
+				}
+			}
+		}
+
+		[Test]
+		public void InsertAndRemoveBatches()
+		{
+			using (var connection = Connection.Open(testDirectory, "create", null))
+			using (var session = connection.OpenSession())
+			{
+				session.Create("table:test", "key_format=u,value_format=u,columns=(k,v)");
+
+				int[] keyOffsets;
+				int[] valueOffsets;
+				var keys = new[] {"c", "a", "b"}.Pack(out keyOffsets);
+				var values = new[] {"3", "1", "22"}.Pack(out valueOffsets);
+				using (var cursor = session.OpenCursor("table:test"))
+				{
+					Assert.That(cursor.InsertBatch(keys, keyOffsets, values, valueOffsets, true, null), Is.EqualTo(0));
+					cursor.AssertAllKeysAndValues("a->1", "b->22", "c->3");
+				}
+				using (var cursor = session.OpenCursor("table:test"))
+				{
+					var removeKeys = new[] {"b", "c"}.Pack(out keyOffsets);
+					Assert.That(cursor.RemoveBatch(removeKeys, keyOffsets, false, null), Is.EqualTo(0));
+					cursor.AssertAllKeysAndValues("a->1");
+				}
+			}
+		}
+
+		[Test]
+		public void InsertBatchReportsPerItemStatuses()
+		{
+			using (var connection = Connection.Open(testDirectory, "create", null))
+			using (var session = connection.OpenSession())
+			{
+				session.Create("table:test", null);
+
+				int[] keyOffsets;
+				int[] valueOffsets;
+				var keys = new[] {"b", "a", "c"}.Pack(out keyOffsets);
+				var values = new[] {"k", "k", "k"}.Pack(out valueOffsets);
+				using (var cursor = session.OpenCursor("table:test", "bulk=true"))
+				{
+					var statuses = new int[3];
+					Assert.That(cursor.InsertBatch(keys, keyOffsets, values, valueOffsets, false, statuses), Is.EqualTo(1));
+					Assert.That(statuses, Is.EqualTo(new[] {0, 22, 0}));
+				}
+				using (var cursor = session.OpenCursor("table:test"))
+					cursor.AssertAllKeysAndValues("b->k", "c->k");
+			}
+		}
+
+		[TestCase("b", true, "d", true, "a->1", "e->5")]
+		[TestCase("b", false, "d", false, "a->1", "b->2", "d->4", "e->5")]
+		[TestCase(null, false, "c", false, "c->3", "d->4", "e->5")]
+		[TestCase("bb", true, null, false, "a->1", "b->2")]
+		[TestCase("bb", true, "bc", true, "a->1", "b->2", "c->3", "d->4", "e->5")]
+		[TestCase(null, false, null, false)]
+		public void TruncateRange(string left, bool leftInclusive, string right, bool rightInclusive, params string[] expected)
+		{
+			using (var connection = Connection.Open(testDirectory, "create", null))
+			using (var session = connection.OpenSession())
+			{
+				session.Create("table:test", "key_format=u,value_format=u,columns=(k,v)");
+				using (var cursor = session.OpenCursor("table:test"))
+				{
+					cursor.Insert("a", "1");
+					cursor.Insert("b", "2");
+					cursor.Insert("c", "3");
+					cursor.Insert("d", "4");
+					cursor.Insert("e", "5");
+				}
+				session.Truncate("table:test", new Range(
+					left == null ? (Boundary?) null : new Boundary(left.B(), leftInclusive),
+					right == null ? (Boundary?) null : new Boundary(right.B(), rightInclusive)));
+				using (var cursor = session.OpenCursor("table:test"))
+					cursor.AssertAllKeysAndValues(expected);
+			}
+		}
+
+		[Test]
+		public void ModifyStoresPartialUpdates()
+		{
+			using (var connection = Connection.Open(testDirectory, "create", null))
+			using (var session = connection.OpenSession())
+			{
+				session.Create("table:test", "key_format=u,value_format=u,columns=(k,v)");
+				using (var cursor = session.OpenCursor("table:test"))
+				{
+					cursor.Insert("a", "hello world");
+					cursor.Insert("b", "0123");
+
+					session.BeginTran();
+					Assert.That(cursor.Modify("a".B(), new[] {0, 6}, new[] {1, 5}, new[] {"H".B(), "there".B()}));
+					Assert.That(cursor.Modify("x".B(), new[] {0}, new[] {0}, new[] {"y".B()}), Is.False);
+					session.CommitTran();
+
+					int[] keyOffsets;
+					int[] dataOffsets;
+					var keys = new[] {"b", "a"}.Pack(out keyOffsets);
+					var data = new[] {"45", "!"}.Pack(out dataOffsets);
+					var statuses = new int[2];
+					session.BeginTran();
+					Assert.That(cursor.ModifyBatch(keys, keyOffsets, new[] {0, 1, 2}, new[] {4, 11}, new[] {0, 0},
+						data, dataOffsets, true, statuses), Is.EqualTo(0));
+					session.CommitTran();
+					Assert.That(statuses, Is.EqualTo(new[] {0, 0}));
+				}
+				using (var cursor = session.OpenCursor("table:test"))
+					cursor.AssertAllKeysAndValues("a->Hello there!", "b->012345");
+			}
+		}
+
+		[Test]
+		public void CachedCursorsAreResetOnReuse()
+		{
+			using (var connection = Connection.Open(testDirectory, "create", null))
+			using (var session = connection.OpenSession())
+			{
+				session.Create("table:test", "key_format=u,value_format=u,columns=(k,v)");
+				using (var cursor = session.OpenCachedCursor("table:test"))
+				{
+					cursor.Insert("a", "1");
+					cursor.Insert("b", "2");
+					cursor.Insert("c", "3");
+					Assert.That(cursor.IterationBegin(Range.Segment("b".B(), "b".B()), Direction.Ascending));
+				}
+				using (var cursor = session.OpenCachedCursor("table:test"))
+				{
+					Assert.That(cursor.IterationBegin(Range.Line(), Direction.Descending));
+					Assert.That(cursor.GetKeyString(), Is.EqualTo("c"));
+					Assert.That(cursor.IterationMove());
+					Assert.That(cursor.IterationMove());
+					Assert.That(cursor.GetKeyString(), Is.EqualTo("a"));
+				}
+				using (var cursor = session.OpenCachedCursor("table:test", "overwrite=false"))
+				{
+					var exception = Assert.Throws<WiredTigerApiException>(() => cursor.Insert("a", "x"));
+					Assert.That(exception.ErrorCode, Is.EqualTo((int) ErrorCodes.WtDuplicateKey));
+				}
+				using (var cursor = session.OpenCachedCursor("table:test"))
+					cursor.AssertAllKeysAndValues("a->1", "b->2", "c->3");
+			}
+		}
+
+		[Test]
+		public void AsyncOperations()
+		{
+			using (var connection = Connection.Open(testDirectory, "create,async=(enabled=true,threads=2)", null))
+			{
+				using (var session = connection.OpenSession())
+				{
+					session.Create("table:test", "key_format=u,value_format=u,columns=(k,v)");
+					session.Create("table:strings", "key_format=S,value_format=S,columns=(k,v)");
+				}
+				Assert.Throws<ArgumentException>(() => connection.InsertAsync("table:strings", "k".B(), "v".B()));
+				var inserts = Enumerable.Range(0, 100)
+					.Select(i => connection.InsertAsync("table:test", ("k" + i).B(), ("v" + i).B()))
+					.ToArray();
+				Task.WaitAll(inserts);
+				Assert.That(connection.SearchAsync("table:test", "k42".B()).Result, Is.EqualTo("v42".B()));
+				Assert.That(connection.SearchAsync("table:test", "missing".B()).Result, Is.Null);
+				Assert.That(connection.RemoveAsync("table:test", "k42".B()).Result, Is.True);
+				Assert.That(connection.RemoveAsync("table:test", "k42".B()).Result, Is.False);
+				var duplicate = connection.InsertAsync("table:test", "overwrite=false", "k1".B(), "x".B());
+				var exception = Assert.Throws<AggregateException>(() => duplicate.Wait());
+				Assert.That(((WiredTigerApiException) exception.InnerException).ErrorCode,
+					Is.EqualTo((int) ErrorCodes.WtDuplicateKey));
+				connection.AsyncFlush();
+			}
+		}
+
+		[Test]
+		public void WriteBatcherCoalescesWritesOfManyThreads()
+		{
+			using (var connection = Connection.Open(testDirectory, "create", null))
+			{
+				using (var session = connection.OpenSession())
+					session.Create("table:test", "key_format=u,value_format=u,columns=(k,v)");
+				using (var batcher = connection.CreateWriteBatcher(2, 64, TimeSpan.FromMilliseconds(1), null))
+				{
+					var tasks = Enumerable.Range(0, 8)
+						.AsParallel()
+						.SelectMany(p => Enumerable.Range(0, 500).Select(i => batcher.InsertAsync("table:test", ("k" + p + "-" + i).B(), "v".B())))
+						.ToArray();
+					Task.WaitAll(tasks);
+					Assert.That(batcher.Writes, Is.EqualTo(4000));
+					Assert.That(batcher.Transactions, Is.LessThan(4000));
+					Assert.That(batcher.RemoveAsync("table:test", "k0-0".B()).Result, Is.True);
+					Assert.That(batcher.RemoveAsync("table:test", "k0-0".B()).Result, Is.False);
+					var missingTable = batcher.InsertAsync("table:missing", "a".B(), "b".B());
+					Assert.Throws<AggregateException>(() => missingTable.Wait());
+				}
+				using (var session = connection.OpenSession())
+				using (var cursor = session.OpenCursor("table:test"))
+				{
+					Assert.That(cursor.Search("k0-0".B()), Is.False);
+					Assert.That(cursor.Search("k7-499".B()), Is.True);
+				}
+			}
+		}
+
+		[Test]
+		public void TryVariantsReturnErrorCodes()
+		{
+			using (var connection = Connection.Open(testDirectory, "create", null))
+			using (var session = connection.OpenSession())
+			{
+				session.Create("table:test", "key_format=u,value_format=u,columns=(k,v)");
+				using (var cursor = session.OpenCursor("table:test", "overwrite=false"))
+				{
+					Assert.That(cursor.TryInsert("a".B(), "1".B()), Is.EqualTo(0));
+					Assert.That(cursor.TryInsert("a".B(), "2".B()), Is.EqualTo((int) ErrorCodes.WtDuplicateKey));
+					Assert.That(cursor.TryModify("b".B(), new[] {0}, new[] {1}, new[] {"x".B()}),
+						Is.EqualTo((int) ErrorCodes.WtNotFound));
+					Assert.That(cursor.TryRemove("b".B()), Is.EqualTo((int) ErrorCodes.WtNotFound));
+					Assert.That(cursor.TryRemove("a".B()), Is.EqualTo(0));
+				}
+				session.BeginTran();
+				Assert.That(session.TryCommitTran(), Is.EqualTo(0));
+			}
+		}
+
+		[Test]
+		public void RunTransactionRetriesConflicts()
+		{
+			using (var connection = Connection.Open(testDirectory, "create", null))
+			using (var session = connection.OpenSession())
+			{
+				session.Create("table:test", "key_format=u,value_format=u,columns=(k,v)");
+				using (var cursor = session.OpenCursor("table:test"))
+				{
+					var attempts = 0;
+					session.RunTransaction(s =>
+					{
+						attempts++;
+						var r = cursor.TryInsert("a".B(), attempts.ToString().B());
+						return r != 0 ? r : attempts < 3 ? (int) ErrorCodes.WtRollback : 0;
+					});
+					Assert.That(attempts, Is.EqualTo(3));
+					cursor.AssertAllKeysAndValues("a->3");
+
+					attempts = 0;
+					var result = session.TryRunTransaction(s =>
+					{
+						attempts++;
+						throw new WiredTigerApiException((int) ErrorCodes.WtRollback, "test");
+					}, null, null, 2);
+					Assert.That(result, Is.EqualTo((int) ErrorCodes.WtRollback));
+					Assert.That(attempts, Is.EqualTo(2));
+
+					Assert.Throws<InvalidOperationException>(() => session.RunTransaction(s =>
+					{
+						cursor.Insert("b".B(), "1".B());
+						throw new InvalidOperationException();
+					}));
+					cursor.AssertAllKeysAndValues("a->3");
+				}
+			}
+		}
+
+		[Test]
+		public void Statistics()
+		{
+			using (var connection = Connection.Open(testDirectory, "create,statistics=(all)", null))
+			using (var session = connection.OpenSession())
+			{
+				session.Create("table:test", "key_format=u,value_format=u,columns=(k,v)");
+				session.BeginTran();
+				using (var cursor = session.OpenCursor("table:test"))
+					for (var i = 0; i < 100; i++)
+						cursor.Insert(("k" + i).B(), "v".B());
+				session.CommitTran();
+				session.Checkpoint(null);
+
+				var connectionStatistics = connection.GetStatistics(true);
+				Assert.That(connectionStatistics.CacheBytesMax, Is.GreaterThan(0));
+				Assert.That(connectionStatistics.TransactionsCommitted, Is.GreaterThan(0));
+				Assert.That(connectionStatistics.Checkpoints, Is.GreaterThan(0));
+
+				var tableStatistics = session.GetTableStatistics("table:test", false);
+				Assert.That(tableStatistics.Entries, Is.GreaterThan(0));
+				Assert.That(tableStatistics.LeafPages, Is.GreaterThan(0));
+				Assert.That(tableStatistics.FileSize, Is.GreaterThan(0));
+				Assert.That(session.GetTableStatistics("table:test", true).CacheBytesInUse, Is.GreaterThan(0));
+			}
+		}
+
+		[Test]
+		public void LatencyHistograms()
+		{
+			using (var connection = Connection.Open(testDirectory, "create", null))
+			using (var session = connection.OpenSession())
+			{
+				session.Create("table:latency", "key_format=u,value_format=u,columns=(k,v)");
+				Connection.LatencyTracking = true;
+				try
+				{
+					using (var cursor = session.OpenCursor("table:latency"))
+						for (var i = 0; i < 100; i++)
+						{
+							cursor.Insert(("k" + i).B(), "v".B());
+							cursor.Reset();
+							Assert.That(cursor.Search(("k" + i).B()));
+						}
+				}
+				finally
+				{
+					Connection.LatencyTracking = false;
+				}
+				var histograms = Connection.GetLatencySnapshot().Where(x => x.Table == "table:latency").ToArray();
+				var inserts = histograms.Single(x => x.Operation == LatencyOperation.Insert);
+				Assert.That(inserts.Count, Is.EqualTo(100));
+				Assert.That(inserts.GetPercentile(50), Is.LessThanOrEqualTo(inserts.GetPercentile(99)));
+				Assert.That(inserts.GetPercentile(100), Is.EqualTo(inserts.MaxNanoseconds));
+				Assert.That(histograms.Single(x => x.Operation == LatencyOperation.Search).Count, Is.EqualTo(100));
+			}
+		}
+
+		[Test]
+		public void SessionPoolReusesSessionsAndBlocksWhenExhausted()
+		{
+			using (var connection = Connection.Open(testDirectory, "create", null))
+			using (var pool = connection.CreateSessionPool(2))
+			{
+				Session first;
+				using (var rented = pool.Rent())
+				{
+					first = rented.Session;
+					first.Create("table:test", "key_format=u,value_format=u,columns=(k,v)");
+				}
+				Assert.That(pool.IdleCount, Is.EqualTo(1));
+				using (var rented = pool.Rent())
+				using (var other = pool.Rent())
+				{
+					Assert.That(rented.Session, Is.SameAs(first));
+					Assert.That(other.Session, Is.Not.SameAs(first));
+					Assert.That(pool.OpenCount, Is.EqualTo(2));
+					Assert.Throws<TimeoutException>(() => pool.Rent(TimeSpan.FromMilliseconds(50)));
+				}
+				Assert.That(pool.IdleCount, Is.EqualTo(2));
+				Assert.That(pool.Trim(TimeSpan.Zero), Is.EqualTo(2));
+				Assert.That(pool.OpenCount, Is.EqualTo(0));
+				using (var rented = pool.Rent())
+				using (var cursor = rented.Session.OpenCursor("table:test"))
+					cursor.Insert("a", "1");
+
+				using (var rented = pool.Rent())
+				{
+					rented.Session.BeginTran();
+					using (var cursor = rented.Session.OpenCursor("table:test"))
+						cursor.Insert("b", "2");
+				}
+				using (var rented = pool.Rent())
+				{
+					rented.Session.BeginTran();
+					using (var cursor = rented.Session.OpenCursor("table:test"))
+						Assert.That(cursor.Search("b".B()), Is.False);
+					rented.Session.RollbackTran();
+				}
+			}
+		}
+
 		[Test]
 		public void HandleCrashesOfErrorHandler()
 		{
@@ -3,7 +3,7 @@ using WiredTigerNet;
 
 namespace Tests
 {
-	public class LoggingEventHandler : IEventHandler
+	public class LoggingEventHandler : IEventHandler, IProgressHandler
 	{
 		public readonly List<object> loggedEvents = new List<object>();
 
@@ -17,6 +17,11 @@ namespace Tests
 			loggedEvents.Add(new MessageEvent {message = message});
 		}
 
+		public void OnProgress(string operation, long progress)
+		{
+			loggedEvents.Add(new ProgressEvent {operation = operation, progress = progress});
+		}
+
 		public class ErrorEvent
 		{
 			public int errorCode;
@@ -28,5 +33,11 @@ namespace Tests
 		{
 			public string message;
 		}
+
+		public class ProgressEvent
+		{
+			public string operation;
+			public long progress;
+		}
 	}
 }
\ No newline at end of file
@@ -18,6 +18,15 @@ namespace Tests
 			return Encoding.ASCII.GetString(b);
 		}
 
+		public static byte[] Pack(this string[] items, out int[] offsets)
+		{
+			offsets = new int[items.Length + 1];
+			var bytes = items.Select(x => x.B()).ToArray();
+			for (var i = 0; i < bytes.Length; i++)
+				offsets[i + 1] = offsets[i] + bytes[i].Length;
+			return bytes.SelectMany(x => x).ToArray();
+		}
+
 		public static void Insert(this Cursor cursor, string key, string value)
 		{
 			cursor.Insert(key.B(), value.B());
@@ -0,0 +1,221 @@
+#include "NativeAsync.h"
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+
+// *************
+// NativeCompletionQueue
+// *************
+
+struct NativeCompletionQueue::State {
+	std::mutex mutex;
+	std::condition_variable available;
+	std::deque<NativeCompletion> items;
+	bool shutdown;
+};
+
+NativeCompletionQueue::NativeCompletionQueue() : state_(new State()) {
+	state_->shutdown = false;
+}
+
+NativeCompletionQueue::~NativeCompletionQueue() {
+	delete state_;
+}
+
+void NativeCompletionQueue::Push(__int64 token, int result, const Byte* value, int valueSize) {
+	NativeCompletion completion;
+	completion.token = token;
+	completion.result = result;
+	if (valueSize > 0)
+		completion.value.assign(value, value + valueSize);
+	bool wasEmpty;
+	{
+		std::lock_guard<std::mutex> lock(state_->mutex);
+		wasEmpty = state_->items.empty();
+		state_->items.push_back(std::move(completion));
+	}
+	// the consumer only sleeps on an empty queue
+	if (wasEmpty)
+		state_->available.notify_one();
+}
+
+bool NativeCompletionQueue::Drain(std::vector<NativeCompletion>& out, int maxCount) {
+	std::unique_lock<std::mutex> lock(state_->mutex);
+	state_->available.wait(lock, [this] { return state_->shutdown || !state_->items.empty(); });
+	if (state_->items.empty())
+		return false;
+	int count = 0;
+	while (!state_->items.empty() && count < maxCount) {
+		out.push_back(std::move(state_->items.front()));
+		state_->items.pop_front();
+		count++;
+	}
+	return true;
+}
+
+void NativeCompletionQueue::Shutdown() {
+	{
+		std::lock_guard<std::mutex> lock(state_->mutex);
+		state_->shutdown = true;
+	}
+	state_->available.notify_all();
+}
+
+// *************
+// NativeAsyncExecutor
+// *************
+
+// WiredTiger passes the callback back to notify, so the executor is found through it
+struct NativeAsyncExecutor::Callback {
+	WT_ASYNC_CALLBACK base;
+	NativeAsyncExecutor* executor;
+	std::atomic<__int64> pending;
+	// signalled when pending drops to zero
+	std::mutex mutex;
+	std::condition_variable drained;
+	// whether a uri has the u formats
+	std::mutex formatsMutex;
+	std::map<std::string, bool> itemFormats;
+
+	static int Notify(WT_ASYNC_CALLBACK* cb, WT_ASYNC_OP* op, int result, uint32_t) {
+		Callback* callback = reinterpret_cast<Callback*>(cb);
+		callback->executor->Complete(op, result);
+		// decremented under the lock, so the executor can't be destroyed before the callback is done with it
+		std::lock_guard<std::mutex> lock(callback->mutex);
+		if (--callback->pending == 0)
+			callback->drained.notify_all();
+		return 0;
+	}
+};
+
+// async_new_op fails with EBUSY while all ops_max operations are in flight
+static const int asyncBusyRetries = 10000;
+
+NativeAsyncExecutor::NativeAsyncExecutor(WT_CONNECTION* connection, NativeCompletionQueue* queue) :
+	connection_(connection), queue_(queue), callback_(nullptr), context_(nullptr), asyncCallback_(new Callback()) {
+	asyncCallback_->base.notify = &Callback::Notify;
+	asyncCallback_->executor = this;
+	asyncCallback_->pending = 0;
+}
+
+NativeAsyncExecutor::NativeAsyncExecutor(WT_CONNECTION* connection, NativeAsyncCallback callback, void* context) :
+	connection_(connection), queue_(nullptr), callback_(callback), context_(context), asyncCallback_(new Callback()) {
+	asyncCallback_->base.notify = &Callback::Notify;
+	asyncCallback_->executor = this;
+	asyncCallback_->pending = 0;
+}
+
+NativeAsyncExecutor::~NativeAsyncExecutor() {
+	// operations hold the callback, it must outlive them
+	connection_->async_flush(connection_);
+	{
+		std::unique_lock<std::mutex> lock(asyncCallback_->mutex);
+		asyncCallback_->drained.wait(lock, [this] { return asyncCallback_->pending == 0; });
+	}
+	delete asyncCallback_;
+}
+
+void NativeAsyncExecutor::Submit(NativeAsyncOpType type, const char* uri, const char* config, __int64 token,
+	const Byte* key, int keySize, const Byte* value, int valueSize) {
+	WT_ASYNC_OP* op;
+	int r;
+	for (int attempt = 0;; attempt++) {
+		r = connection_->async_new_op(connection_, uri, config, &asyncCallback_->base, &op);
+		if (r != EBUSY || attempt >= asyncBusyRetries)
+			break;
+		if (attempt < 16)
+			std::this_thread::yield();
+		else
+			std::this_thread::sleep_for(std::chrono::microseconds(100));
+	}
+	if (r != 0)
+		throw NativeWiredTigerApiException(r, std::string("connection->async_new_op, ") + uri);
+	op->app_private = reinterpret_cast<void*>(token);
+	// the op copies key and value into its own buffers
+	WT_ITEM keyItem = { 0 };
+	keyItem.data = key;
+	keyItem.size = keySize;
+	op->set_key(op, &keyItem);
+	const char* apiName;
+	asyncCallback_->pending++;
+	switch (type) {
+	case NativeAsyncSearch:
+		apiName = "async_op->search";
+		r = op->search(op);
+		break;
+	case NativeAsyncInsert:
+	case NativeAsyncUpdate: {
+		WT_ITEM valueItem = { 0 };
+		valueItem.data = value;
+		valueItem.size = valueSize;
+		op->set_value(op, &valueItem);
+		apiName = type == NativeAsyncInsert ? "async_op->insert" : "async_op->update";
+		r = type == NativeAsyncInsert ? op->insert(op) : op->update(op);
+		break;
+	}
+	case NativeAsyncRemove:
+		apiName = "async_op->remove";
+		r = op->remove(op);
+		break;
+	default:
+		apiName = "async_op";
+		r = EINVAL;
+		break;
+	}
+	if (r != 0) {
+		asyncCallback_->pending--;
+		throw NativeWiredTigerApiException(r, std::string(apiName) + ", " + uri);
+	}
+}
+
+bool NativeAsyncExecutor::HasItemFormats(const char* uri) {
+	std::lock_guard<std::mutex> lock(asyncCallback_->formatsMutex);
+	std::map<std::string, bool>::iterator it = asyncCallback_->itemFormats.find(uri);
+	if (it != asyncCallback_->itemFormats.end())
+		return it->second;
+	WT_SESSION* session;
+	if (connection_->open_session(connection_, nullptr, nullptr, &session) != 0)
+		return true;
+	WT_CURSOR* cursor;
+	bool result = true;
+	if (session->open_cursor(session, uri, nullptr, nullptr, &cursor) == 0) {
+		result = strcmp(cursor->key_format, "u") == 0 && strcmp(cursor->value_format, "u") == 0;
+		asyncCallback_->itemFormats[uri] = result;
+	}
+	// closing the session closes the cursor
+	session->close(session, nullptr);
+	return result;
+}
+
+void NativeAsyncExecutor::Flush() {
+	int r = connection_->async_flush(connection_);
+	if (r != 0)
+		throw NativeWiredTigerApiException(r, "connection->async_flush");
+}
+
+__int64 NativeAsyncExecutor::Pending() const {
+	return asyncCallback_->pending;
+}
+
+void NativeAsyncExecutor::Complete(WT_ASYNC_OP* op, int result) {
+	__int64 token = reinterpret_cast<__int64>(op->app_private);
+	const Byte* value = nullptr;
+	int valueSize = 0;
+	if (result == 0 && op->get_type(op) == WT_AOP_SEARCH) {
+		WT_ITEM item = { 0 };
+		result = op->get_value(op, &item);
+		if (result == 0) {
+			value = (const Byte*)item.data;
+			valueSize = (int)item.size;
+		}
+	}
+	if (queue_ != nullptr)
+		queue_->Push(token, result, value, valueSize);
+	else
+		callback_(context_, token, result, value, valueSize);
+}
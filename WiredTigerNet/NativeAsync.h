@@ -0,0 +1,63 @@
+#pragma once
+#include "NativeTiger.h"
+
+struct NativeCompletion {
+	__int64 token;
+	int result;
+	std::vector<Byte> value;
+};
+
+// Completions posted by native threads and drained in batches by a single consumer.
+class NativeCompletionQueue {
+public:
+	NativeCompletionQueue();
+	~NativeCompletionQueue();
+	void Push(__int64 token, int result, const Byte* value, int valueSize);
+	// Waits until completions are available, moves up to maxCount of them to out.
+	// Returns false once Shutdown was called and the queue is empty.
+	bool Drain(std::vector<NativeCompletion>& out, int maxCount);
+	void Shutdown();
+private:
+	struct State;
+	NativeCompletionQueue(const NativeCompletionQueue&);
+	NativeCompletionQueue& operator=(const NativeCompletionQueue&);
+	State* state_;
+};
+
+enum NativeAsyncOpType {
+	NativeAsyncSearch,
+	NativeAsyncInsert,
+	NativeAsyncUpdate,
+	NativeAsyncRemove
+};
+
+// Called on WiredTiger async worker threads, value is only valid during the call
+typedef void(*NativeAsyncCallback)(void* context, __int64 token, int result, const Byte* value, int valueSize);
+
+// Submits operations to the WiredTiger async worker threads, the connection must be opened with async=(enabled=true).
+// Completions are either posted to a queue or passed to a callback.
+class NativeAsyncExecutor {
+public:
+	NativeAsyncExecutor(WT_CONNECTION* connection, NativeCompletionQueue* queue);
+	NativeAsyncExecutor(WT_CONNECTION* connection, NativeAsyncCallback callback, void* context);
+	// Waits for submitted operations to complete
+	~NativeAsyncExecutor();
+	// Keys and values are passed as WT_ITEMs, so uri must have key_format=u and value_format=u
+	void Submit(NativeAsyncOpType type, const char* uri, const char* config, __int64 token,
+		const Byte* key, int keySize, const Byte* value, int valueSize);
+	// Whether uri has the formats Submit needs, the formats of every uri are read once with a cursor.
+	// Returns true when uri can't be opened, so that Submit reports the error.
+	bool HasItemFormats(const char* uri);
+	void Flush();
+	__int64 Pending() const;
+private:
+	struct Callback;
+	NativeAsyncExecutor(const NativeAsyncExecutor&);
+	NativeAsyncExecutor& operator=(const NativeAsyncExecutor&);
+	void Complete(WT_ASYNC_OP* op, int result);
+	WT_CONNECTION* connection_;
+	NativeCompletionQueue* queue_;
+	NativeAsyncCallback callback_;
+	void* context_;
+	Callback* asyncCallback_;
+};
@@ -0,0 +1,335 @@
+#include "NativeBulkLoader.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <queue>
+#include <sstream>
+#include <thread>
+
+namespace {
+	struct Entry {
+		size_t offset;
+		int keySize;
+		int valueSize;
+	};
+
+	struct Run {
+		std::vector<Byte> data;
+		std::vector<Entry> entries;
+		std::string path;
+	};
+
+	int CompareBytes(const Byte* a, int aSize, const Byte* b, int bSize) {
+		int result = memcmp(a, b, aSize < bSize ? aSize : bSize);
+		if (result == 0 && aSize != bSize)
+			result = aSize < bSize ? -1 : 1;
+		return result;
+	}
+
+	// Stable sort keeps equal keys in the order they were added, so the last of each group wins
+	void SortRun(Run* run) {
+		const Byte* data = run->data.data();
+		std::stable_sort(run->entries.begin(), run->entries.end(), [data](const Entry& a, const Entry& b) {
+			return CompareBytes(data + a.offset, a.keySize, data + b.offset, b.keySize) < 0;
+		});
+		size_t target = 0;
+		for (size_t i = 0; i < run->entries.size(); i++) {
+			const Entry& entry = run->entries[i];
+			if (target > 0) {
+				const Entry& last = run->entries[target - 1];
+				if (CompareBytes(data + last.offset, last.keySize, data + entry.offset, entry.keySize) == 0) {
+					run->entries[target - 1] = entry;
+					continue;
+				}
+			}
+			run->entries[target++] = entry;
+		}
+		run->entries.resize(target);
+	}
+
+	int WriteRun(Run* run) {
+		FILE* file = fopen(run->path.c_str(), "wb");
+		if (file == nullptr)
+			return errno;
+		setvbuf(file, nullptr, _IOFBF, 1 << 20);
+		const Byte* data = run->data.data();
+		for (size_t i = 0; i < run->entries.size(); i++) {
+			const Entry& entry = run->entries[i];
+			int sizes[2] = { entry.keySize, entry.valueSize };
+			size_t recordSize = (size_t)entry.keySize + entry.valueSize;
+			if (fwrite(sizes, sizeof(sizes), 1, file) != 1 ||
+				(recordSize > 0 && fwrite(data + entry.offset, recordSize, 1, file) != 1)) {
+				int r = errno;
+				fclose(file);
+				return r != 0 ? r : EIO;
+			}
+		}
+		if (fclose(file) != 0)
+			return errno != 0 ? errno : EIO;
+		return 0;
+	}
+
+	class RunReader {
+	public:
+		RunReader(int index) : index_(index), file_(nullptr) {
+		}
+		~RunReader() {
+			if (file_ != nullptr)
+				fclose(file_);
+		}
+		void Open(const std::string& path) {
+			file_ = fopen(path.c_str(), "rb");
+			if (file_ == nullptr)
+				throw NativeWiredTigerApiException(errno, "bulk loader: open run " + path);
+			setvbuf(file_, nullptr, _IOFBF, 1 << 20);
+		}
+		bool Next() {
+			int sizes[2];
+			if (fread(sizes, sizeof(sizes), 1, file_) != 1) {
+				if (feof(file_))
+					return false;
+				throw NativeWiredTigerApiException(errno != 0 ? errno : EIO, "bulk loader: read run");
+			}
+			keySize_ = sizes[0];
+			valueSize_ = sizes[1];
+			record_.resize((size_t)keySize_ + valueSize_);
+			if (!record_.empty() && fread(record_.data(), record_.size(), 1, file_) != 1)
+				throw NativeWiredTigerApiException(errno != 0 ? errno : EIO, "bulk loader: read run");
+			return true;
+		}
+		int Index() const { return index_; }
+		Byte* Key() { return record_.data(); }
+		int KeySize() const { return keySize_; }
+		Byte* Value() { return record_.data() + keySize_; }
+		int ValueSize() const { return valueSize_; }
+	private:
+		int index_;
+		FILE* file_;
+		std::vector<Byte> record_;
+		int keySize_;
+		int valueSize_;
+	};
+
+	// Top of the queue is the smallest key, among equal keys the latest run
+	struct ReaderAfter {
+		bool operator()(RunReader* a, RunReader* b) const {
+			int result = CompareBytes(a->Key(), a->KeySize(), b->Key(), b->KeySize());
+			return result != 0 ? result > 0 : a->Index() < b->Index();
+		}
+	};
+}
+
+struct NativeBulkLoader::State {
+	NativeCursor* cursor;
+	bool hasValue;
+	std::string filePrefix;
+	size_t runBytes;
+	int threads;
+	Run* current;
+	std::vector<std::string> runFiles;
+	std::deque<Run*> pending;
+	int active;
+	bool stopping;
+	bool completed;
+	int error;
+	std::string errorApi;
+	std::mutex mutex;
+	std::condition_variable workAvailable;
+	std::condition_variable workDone;
+	std::vector<std::thread> workers;
+
+	void Work() {
+		std::unique_lock<std::mutex> lock(mutex);
+		while (true) {
+			workAvailable.wait(lock, [this] { return stopping || !pending.empty(); });
+			if (pending.empty())
+				return;
+			Run* run = pending.front();
+			pending.pop_front();
+			active++;
+			lock.unlock();
+			SortRun(run);
+			int r = WriteRun(run);
+			std::string path = run->path;
+			delete run;
+			lock.lock();
+			active--;
+			if (r != 0 && error == 0) {
+				error = r;
+				errorApi = "bulk loader: write run " + path;
+			}
+			workDone.notify_all();
+		}
+	}
+
+	void ThrowIfFailed() {
+		if (error != 0)
+			throw NativeWiredTigerApiException(error, errorApi);
+	}
+
+	void Submit() {
+		std::unique_lock<std::mutex> lock(mutex);
+		// at most threads runs are sorted or queued at once, which bounds memory to (threads + 1) * runBytes
+		workDone.wait(lock, [this] { return error != 0 || (int)pending.size() + active < threads; });
+		ThrowIfFailed();
+		std::ostringstream path;
+		path << filePrefix << runFiles.size() << ".run";
+		current->path = path.str();
+		runFiles.push_back(current->path);
+		pending.push_back(current);
+		current = new Run();
+		workAvailable.notify_one();
+	}
+
+	void WaitAll() {
+		std::unique_lock<std::mutex> lock(mutex);
+		workDone.wait(lock, [this] { return pending.empty() && active == 0; });
+		ThrowIfFailed();
+	}
+
+	void Stop() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		workAvailable.notify_all();
+		for (size_t i = 0; i < workers.size(); i++)
+			workers[i].join();
+		workers.clear();
+	}
+
+	void Insert(Byte* key, int keySize, Byte* value, int valueSize) {
+		if (hasValue)
+			cursor->Insert(key, keySize, value, valueSize);
+		else
+			cursor->Insert(key, keySize);
+	}
+
+	__int64 LoadCurrent() {
+		SortRun(current);
+		Byte* data = current->data.data();
+		for (size_t i = 0; i < current->entries.size(); i++) {
+			const Entry& entry = current->entries[i];
+			Insert(data + entry.offset, entry.keySize, data + entry.offset + entry.keySize, entry.valueSize);
+		}
+		return (__int64)current->entries.size();
+	}
+
+	__int64 MergeRuns() {
+		std::vector<RunReader*> readers;
+		__int64 rows = 0;
+		try {
+			std::priority_queue<RunReader*, std::vector<RunReader*>, ReaderAfter> queue;
+			for (size_t i = 0; i < runFiles.size(); i++) {
+				RunReader* reader = new RunReader((int)i);
+				readers.push_back(reader);
+				reader->Open(runFiles[i]);
+				if (reader->Next())
+					queue.push(reader);
+			}
+			while (!queue.empty()) {
+				RunReader* top = queue.top();
+				queue.pop();
+				Insert(top->Key(), top->KeySize(), top->Value(), top->ValueSize());
+				rows++;
+				while (!queue.empty() && CompareBytes(queue.top()->Key(), queue.top()->KeySize(), top->Key(), top->KeySize()) == 0) {
+					RunReader* shadowed = queue.top();
+					queue.pop();
+					if (shadowed->Next())
+						queue.push(shadowed);
+				}
+				if (top->Next())
+					queue.push(top);
+			}
+		}
+		catch (...) {
+			for (size_t i = 0; i < readers.size(); i++)
+				delete readers[i];
+			throw;
+		}
+		for (size_t i = 0; i < readers.size(); i++)
+			delete readers[i];
+		return rows;
+	}
+
+	void RemoveFiles() {
+		for (size_t i = 0; i < runFiles.size(); i++)
+			remove(runFiles[i].c_str());
+		runFiles.clear();
+	}
+};
+
+NativeBulkLoader::NativeBulkLoader(NativeCursor* cursor, const char* tempDirectory, __int64 runBytes, int threads) :
+	state_(new State()) {
+	state_->cursor = cursor;
+	state_->hasValue = strcmp(cursor->ValueFormat(), "") != 0;
+	std::ostringstream prefix;
+	prefix << tempDirectory << "/wtnet-bulk-" << (const void*)this << "-"
+		<< std::chrono::system_clock::now().time_since_epoch().count() << "-";
+	state_->filePrefix = prefix.str();
+	state_->runBytes = (size_t)runBytes;
+	state_->threads = threads;
+	state_->current = new Run();
+	state_->active = 0;
+	state_->stopping = false;
+	state_->completed = false;
+	state_->error = 0;
+	for (int i = 0; i < threads; i++)
+		state_->workers.push_back(std::thread([this] { state_->Work(); }));
+}
+
+NativeBulkLoader::~NativeBulkLoader() {
+	state_->Stop();
+	for (size_t i = 0; i < state_->pending.size(); i++)
+		delete state_->pending[i];
+	delete state_->current;
+	state_->RemoveFiles();
+	if (state_->cursor != nullptr)
+		delete state_->cursor;
+	delete state_;
+}
+
+void NativeBulkLoader::Add(const Byte* key, int keySize, const Byte* value, int valueSize) {
+	if (state_->completed)
+		throw NativeWiredTigerApiException(EINVAL, "bulk loader: add after complete");
+	Run* run = state_->current;
+	Entry entry = { run->data.size(), keySize, valueSize };
+	run->data.insert(run->data.end(), key, key + keySize);
+	if (valueSize > 0)
+		run->data.insert(run->data.end(), value, value + valueSize);
+	run->entries.push_back(entry);
+	if (run->data.size() + run->entries.size() * sizeof(Entry) >= state_->runBytes)
+		state_->Submit();
+}
+
+__int64 NativeBulkLoader::Complete() {
+	if (state_->completed)
+		throw NativeWiredTigerApiException(EINVAL, "bulk loader: complete called twice");
+	state_->completed = true;
+	__int64 rows;
+	if (state_->runFiles.empty())
+		rows = state_->LoadCurrent();
+	else {
+		if (!state_->current->entries.empty())
+			state_->Submit();
+		state_->WaitAll();
+		rows = state_->MergeRuns();
+	}
+	state_->Stop();
+	state_->RemoveFiles();
+	NativeCursor* cursor = state_->cursor;
+	state_->cursor = nullptr;
+	// closing the bulk cursor is what finishes the load
+	delete cursor;
+	return rows;
+}
+
+NativeBulkLoader* OpenNativeBulkLoader(WT_SESSION* session, const char* name, const char* tempDirectory, __int64 runBytes, int threads) {
+	NativeCursor* cursor = OpenNativeCursor(session, name, "bulk=true");
+	return new NativeBulkLoader(cursor, tempDirectory, runBytes, threads);
+}
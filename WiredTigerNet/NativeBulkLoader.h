@@ -0,0 +1,22 @@
+#pragma once
+#include "NativeTiger.h"
+
+// Accepts pairs in any order, sorts them into runs on background threads, spilling runs
+// to tempDirectory, and merges the runs into a bulk cursor on Complete. When the same key
+// is added several times the last added value wins.
+class NativeBulkLoader {
+public:
+	~NativeBulkLoader();
+	void Add(const Byte* key, int keySize, const Byte* value, int valueSize);
+	__int64 Complete();
+
+	friend NativeBulkLoader* OpenNativeBulkLoader(WT_SESSION* session, const char* name, const char* tempDirectory, __int64 runBytes, int threads);
+private:
+	struct State;
+	NativeBulkLoader(NativeCursor* cursor, const char* tempDirectory, __int64 runBytes, int threads);
+	NativeBulkLoader(const NativeBulkLoader&);
+	NativeBulkLoader& operator=(const NativeBulkLoader&);
+	State* state_;
+};
+
+NativeBulkLoader* OpenNativeBulkLoader(WT_SESSION* session, const char* name, const char* tempDirectory, __int64 runBytes, int threads);
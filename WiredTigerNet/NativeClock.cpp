@@ -0,0 +1,32 @@
+#include "NativeClock.h"
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#ifdef _WIN32
+__int64 NativeClockTicks() {
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+	return counter.QuadPart;
+}
+
+__int64 NativeClockFrequency() {
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency(&frequency);
+	return frequency.QuadPart;
+}
+#else
+__int64 NativeClockTicks() {
+	timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (__int64)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+__int64 NativeClockFrequency() {
+	return 1000000000;
+}
+#endif
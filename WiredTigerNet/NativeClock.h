@@ -0,0 +1,5 @@
+#pragma once
+
+// Monotonic high resolution clock, QueryPerformanceCounter on Windows and clock_gettime elsewhere
+__int64 NativeClockTicks();
+__int64 NativeClockFrequency();
@@ -0,0 +1,195 @@
+#include "NativeEventRing.h"
+#include "NativeProgress.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+namespace {
+	// Longer messages are truncated, slots have a fixed size so that producers never allocate
+	const size_t eventMessageSize = 512;
+
+	struct EventSlot {
+		// Bounded queue of Dmitry Vyukov: a slot at position pos is free when its sequence is pos
+		// and holds an event when it is pos + 1
+		std::atomic<size_t> sequence;
+		NativeEventType type;
+		int errorCode;
+		unsigned __int64 progress;
+		size_t length;
+		char message[eventMessageSize];
+	};
+}
+
+struct NativeEventRing::State {
+	// WiredTiger passes the handler back to the callbacks, so the state is found through it
+	struct Handler {
+		WT_EVENT_HANDLER base;
+		State* state;
+	};
+
+	Handler handler;
+	EventSlot* slots;
+	size_t mask;
+	std::atomic<size_t> enqueuePosition;
+	size_t dequeuePosition;
+	std::atomic<bool> sleeping;
+	std::atomic<bool> shutdown;
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::atomic<__int64> droppedErrors;
+	std::atomic<__int64> droppedMessages;
+	std::atomic<__int64> droppedProgress;
+	NativeProgressLimiter* limiter;
+
+	static int HandleError(WT_EVENT_HANDLER* handler, WT_SESSION*, int error, const char* message) {
+		reinterpret_cast<Handler*>(handler)->state->Push(NativeEventError, error, 0, message);
+		return 0;
+	}
+
+	static int HandleMessage(WT_EVENT_HANDLER* handler, WT_SESSION*, const char* message) {
+		reinterpret_cast<Handler*>(handler)->state->Push(NativeEventMessage, 0, 0, message);
+		return 0;
+	}
+
+	static int HandleProgress(WT_EVENT_HANDLER* handler, WT_SESSION* session, const char* operation, uint64_t progress) {
+		State* state = reinterpret_cast<Handler*>(handler)->state;
+		if (state->limiter->Admit(session, operation))
+			state->Push(NativeEventProgress, 0, progress, operation);
+		return 0;
+	}
+
+	std::atomic<__int64>& Dropped(NativeEventType type) {
+		if (type == NativeEventError)
+			return droppedErrors;
+		return type == NativeEventMessage ? droppedMessages : droppedProgress;
+	}
+
+	void Push(NativeEventType type, int errorCode, unsigned __int64 progress, const char* message) {
+		size_t position = enqueuePosition.load(std::memory_order_relaxed);
+		EventSlot* slot;
+		while (true) {
+			slot = &slots[position & mask];
+			size_t sequence = slot->sequence.load(std::memory_order_acquire);
+			ptrdiff_t difference = (ptrdiff_t)sequence - (ptrdiff_t)position;
+			if (difference == 0) {
+				if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if (difference < 0) {
+				Dropped(type)++;
+				return;
+			}
+			else
+				position = enqueuePosition.load(std::memory_order_relaxed);
+		}
+		slot->type = type;
+		slot->errorCode = errorCode;
+		slot->progress = progress;
+		size_t length = message == nullptr ? 0 : strlen(message);
+		slot->length = length < eventMessageSize ? length : eventMessageSize;
+		if (slot->length > 0)
+			memcpy(slot->message, message, slot->length);
+		slot->sequence.store(position + 1, std::memory_order_release);
+		// pairs with the fence in Drain: either the producer sees sleeping or the consumer sees the event
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (sleeping.load()) {
+			std::lock_guard<std::mutex> lock(mutex);
+			sleeping = false;
+			wake.notify_one();
+		}
+	}
+
+	bool Available() {
+		return slots[dequeuePosition & mask].sequence.load(std::memory_order_acquire) == dequeuePosition + 1;
+	}
+
+	void Pop(std::vector<NativeEvent>& out) {
+		EventSlot& slot = slots[dequeuePosition & mask];
+		NativeEvent event;
+		event.type = slot.type;
+		event.errorCode = slot.errorCode;
+		event.progress = slot.progress;
+		event.message.assign(slot.message, slot.length);
+		out.push_back(std::move(event));
+		slot.sequence.store(dequeuePosition + mask + 1, std::memory_order_release);
+		dequeuePosition++;
+	}
+};
+
+NativeEventRing::NativeEventRing(int capacity, int progressIntervalMilliseconds) : state_(new State()) {
+	size_t size = 1;
+	while (size < (size_t)capacity)
+		size <<= 1;
+	state_->slots = new EventSlot[size];
+	for (size_t i = 0; i < size; i++)
+		state_->slots[i].sequence.store(i, std::memory_order_relaxed);
+	state_->mask = size - 1;
+	state_->enqueuePosition = 0;
+	state_->dequeuePosition = 0;
+	state_->sleeping = false;
+	state_->shutdown = false;
+	state_->droppedErrors = 0;
+	state_->droppedMessages = 0;
+	state_->droppedProgress = 0;
+	state_->limiter = progressIntervalMilliseconds < 0 ? nullptr : new NativeProgressLimiter(progressIntervalMilliseconds);
+	state_->handler.base.handle_error = &State::HandleError;
+	state_->handler.base.handle_message = &State::HandleMessage;
+	state_->handler.base.handle_progress = state_->limiter == nullptr ? nullptr : &State::HandleProgress;
+	state_->handler.base.handle_close = nullptr;
+	state_->handler.state = state_;
+}
+
+NativeEventRing::~NativeEventRing() {
+	delete[] state_->slots;
+	delete state_->limiter;
+	delete state_;
+}
+
+WT_EVENT_HANDLER* NativeEventRing::Handler() {
+	return &state_->handler.base;
+}
+
+bool NativeEventRing::Drain(std::vector<NativeEvent>& out, int maxCount) {
+	while (true) {
+		int count = 0;
+		while (count < maxCount && state_->Available()) {
+			state_->Pop(out);
+			count++;
+		}
+		if (count > 0)
+			return true;
+		std::unique_lock<std::mutex> lock(state_->mutex);
+		state_->sleeping = true;
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (state_->Available()) {
+			state_->sleeping = false;
+			continue;
+		}
+		if (state_->shutdown) {
+			state_->sleeping = false;
+			return false;
+		}
+		// a producer that publishes after the check above sees sleeping and notifies, Shutdown notifies too
+		State* state = state_;
+		state->wake.wait(lock, [state] { return !state->sleeping || state->shutdown; });
+		state_->sleeping = false;
+	}
+}
+
+void NativeEventRing::Shutdown() {
+	state_->shutdown = true;
+	std::lock_guard<std::mutex> lock(state_->mutex);
+	state_->wake.notify_all();
+}
+
+__int64 NativeEventRing::DroppedErrors() const {
+	return state_->droppedErrors;
+}
+
+__int64 NativeEventRing::DroppedMessages() const {
+	return state_->droppedMessages;
+}
+
+__int64 NativeEventRing::DroppedProgress() const {
+	return state_->droppedProgress;
+}
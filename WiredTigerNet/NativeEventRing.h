@@ -0,0 +1,41 @@
+#pragma once
+#include "NativeTiger.h"
+
+enum NativeEventType {
+	NativeEventError,
+	NativeEventMessage,
+	NativeEventProgress
+};
+
+struct NativeEvent {
+	NativeEventType type;
+	int errorCode;
+	unsigned __int64 progress;
+	// the operation name for progress events
+	std::string message;
+};
+
+// Event handler for wiredtiger_open that copies errors, messages and progress into a bounded lock-free ring
+// instead of calling out on WiredTiger threads. A single consumer drains the ring in batches.
+// Events that find the ring full are dropped and counted, longer messages are truncated.
+class NativeEventRing {
+public:
+	// capacity is rounded up to a power of two. Progress reports are throttled by a NativeProgressLimiter
+	// and are not handled at all when progressIntervalMilliseconds is negative.
+	NativeEventRing(int capacity, int progressIntervalMilliseconds);
+	~NativeEventRing();
+	// Valid for the lifetime of the ring, which must outlive the connection
+	WT_EVENT_HANDLER* Handler();
+	// Waits until events are available, moves up to maxCount of them to out.
+	// Returns false once Shutdown was called and the ring is empty.
+	bool Drain(std::vector<NativeEvent>& out, int maxCount);
+	void Shutdown();
+	__int64 DroppedErrors() const;
+	__int64 DroppedMessages() const;
+	__int64 DroppedProgress() const;
+private:
+	struct State;
+	NativeEventRing(const NativeEventRing&);
+	NativeEventRing& operator=(const NativeEventRing&);
+	State* state_;
+};
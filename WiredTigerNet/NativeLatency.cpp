@@ -0,0 +1,213 @@
+#include "NativeLatency.h"
+#include <atomic>
+#include <map>
+#include <mutex>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define LATENCY_THREAD_LOCAL __declspec(thread)
+#else
+#define LATENCY_THREAD_LOCAL __thread
+#endif
+
+namespace {
+	const int subBucketBits = 4;
+	const int subBucketCount = 1 << subBucketBits;
+
+	int HighestBit(unsigned __int64 value) {
+#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanReverse64(&index, value);
+		return (int)index;
+#else
+		return 63 - __builtin_clzll(value);
+#endif
+	}
+
+	int BucketIndex(unsigned __int64 nanoseconds) {
+		if (nanoseconds < 2 * subBucketCount)
+			return (int)nanoseconds;
+		int shift = HighestBit(nanoseconds) - subBucketBits;
+		int index = shift * subBucketCount + (int)(nanoseconds >> shift);
+		return index < latencyBucketCount ? index : latencyBucketCount - 1;
+	}
+
+	// Written only by the owning thread, so increments need no atomic read-modify-write,
+	// atomics only keep concurrent snapshots well defined
+	struct OpHistogram {
+		std::atomic<unsigned __int64> buckets[latencyBucketCount];
+		std::atomic<unsigned __int64> count;
+		std::atomic<unsigned __int64> total;
+		std::atomic<unsigned __int64> max;
+
+		OpHistogram() {
+			for (int i = 0; i < latencyBucketCount; i++)
+				buckets[i].store(0, std::memory_order_relaxed);
+			count.store(0, std::memory_order_relaxed);
+			total.store(0, std::memory_order_relaxed);
+			max.store(0, std::memory_order_relaxed);
+		}
+
+		static void Add(std::atomic<unsigned __int64>& counter, unsigned __int64 value) {
+			counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+		}
+
+		void Record(unsigned __int64 nanoseconds) {
+			Add(buckets[BucketIndex(nanoseconds)], 1);
+			Add(count, 1);
+			Add(total, nanoseconds);
+			if (nanoseconds > max.load(std::memory_order_relaxed))
+				max.store(nanoseconds, std::memory_order_relaxed);
+		}
+	};
+
+	struct TableHistograms {
+		OpHistogram* ops[NativeLatencyOpCount];
+	};
+
+	// Histograms of one thread. The owner reads its pointers without locking and takes
+	// the mutex only to publish new histograms, snapshots hold the mutex while reading.
+	struct LatencyShard {
+		std::mutex mutex;
+		std::vector<TableHistograms*> tables;
+	};
+
+	struct LatencyRegistry {
+		std::mutex mutex;
+		std::map<std::string, int> tableIds;
+		std::vector<std::string> tableNames;
+		std::vector<LatencyShard*> shards;
+		double nanosecondsPerTick;
+	};
+
+	std::atomic<bool> latencyTracking(false);
+	std::atomic<LatencyRegistry*> latencyRegistry(nullptr);
+	LATENCY_THREAD_LOCAL LatencyShard* currentShard = nullptr;
+
+	// Created on first use and kept for the process lifetime, like the thread shards
+	LatencyRegistry* Registry() {
+		LatencyRegistry* registry = latencyRegistry.load(std::memory_order_acquire);
+		if (registry != nullptr)
+			return registry;
+		LatencyRegistry* created = new LatencyRegistry();
+		created->nanosecondsPerTick = 1e9 / (double)NativeClockFrequency();
+		if (latencyRegistry.compare_exchange_strong(registry, created))
+			return created;
+		delete created;
+		return registry;
+	}
+
+	LatencyShard* CurrentShard() {
+		if (currentShard == nullptr) {
+			LatencyShard* shard = new LatencyShard();
+			LatencyRegistry* registry = Registry();
+			std::lock_guard<std::mutex> lock(registry->mutex);
+			registry->shards.push_back(shard);
+			currentShard = shard;
+		}
+		return currentShard;
+	}
+
+	OpHistogram* Histogram(LatencyShard* shard, int table, NativeLatencyOp op) {
+		if (table < (int)shard->tables.size()) {
+			TableHistograms* histograms = shard->tables[table];
+			if (histograms != nullptr && histograms->ops[op] != nullptr)
+				return histograms->ops[op];
+		}
+		std::lock_guard<std::mutex> lock(shard->mutex);
+		if (table >= (int)shard->tables.size())
+			shard->tables.resize(table + 1, nullptr);
+		TableHistograms*& histograms = shard->tables[table];
+		if (histograms == nullptr) {
+			histograms = new TableHistograms();
+			for (int i = 0; i < NativeLatencyOpCount; i++)
+				histograms->ops[i] = nullptr;
+		}
+		if (histograms->ops[op] == nullptr)
+			histograms->ops[op] = new OpHistogram();
+		return histograms->ops[op];
+	}
+}
+
+void SetLatencyTracking(bool enabled) {
+	if (enabled)
+		Registry();
+	latencyTracking.store(enabled, std::memory_order_relaxed);
+}
+
+bool IsLatencyTracking() {
+	return latencyTracking.load(std::memory_order_relaxed);
+}
+
+int InternLatencyTable(const char* name) {
+	LatencyRegistry* registry = Registry();
+	std::lock_guard<std::mutex> lock(registry->mutex);
+	std::map<std::string, int>::iterator it = registry->tableIds.find(name);
+	if (it != registry->tableIds.end())
+		return it->second;
+	int id = (int)registry->tableNames.size();
+	registry->tableNames.push_back(name);
+	registry->tableIds[name] = id;
+	return id;
+}
+
+void RecordLatency(int table, NativeLatencyOp op, __int64 ticks) {
+	if (ticks < 0)
+		ticks = 0;
+	unsigned __int64 nanoseconds = (unsigned __int64)(ticks * Registry()->nanosecondsPerTick);
+	Histogram(CurrentShard(), table, op)->Record(nanoseconds);
+}
+
+void SnapshotLatency(std::vector<NativeLatencySnapshot>& out) {
+	LatencyRegistry* registry = Registry();
+	std::vector<LatencyShard*> shards;
+	std::vector<std::string> tableNames;
+	{
+		std::lock_guard<std::mutex> lock(registry->mutex);
+		shards = registry->shards;
+		tableNames = registry->tableNames;
+	}
+	std::map<std::pair<int, int>, size_t> positions;
+	for (size_t s = 0; s < shards.size(); s++) {
+		LatencyShard* shard = shards[s];
+		std::lock_guard<std::mutex> lock(shard->mutex);
+		for (size_t table = 0; table < shard->tables.size(); table++) {
+			TableHistograms* histograms = shard->tables[table];
+			if (histograms == nullptr)
+				continue;
+			for (int op = 0; op < NativeLatencyOpCount; op++) {
+				OpHistogram* histogram = histograms->ops[op];
+				if (histogram == nullptr)
+					continue;
+				std::pair<int, int> key((int)table, op);
+				std::map<std::pair<int, int>, size_t>::iterator it = positions.find(key);
+				if (it == positions.end()) {
+					NativeLatencySnapshot snapshot;
+					snapshot.table = tableNames[table];
+					snapshot.op = (NativeLatencyOp)op;
+					snapshot.count = 0;
+					snapshot.totalNanoseconds = 0;
+					snapshot.maxNanoseconds = 0;
+					snapshot.buckets.assign(latencyBucketCount, 0);
+					it = positions.insert(std::make_pair(key, out.size())).first;
+					out.push_back(snapshot);
+				}
+				NativeLatencySnapshot& snapshot = out[it->second];
+				snapshot.count += histogram->count.load(std::memory_order_relaxed);
+				snapshot.totalNanoseconds += histogram->total.load(std::memory_order_relaxed);
+				__int64 max = histogram->max.load(std::memory_order_relaxed);
+				if (max > snapshot.maxNanoseconds)
+					snapshot.maxNanoseconds = max;
+				for (int i = 0; i < latencyBucketCount; i++)
+					snapshot.buckets[i] += histogram->buckets[i].load(std::memory_order_relaxed);
+			}
+		}
+	}
+}
+
+__int64 LatencyBucketUpperBound(int bucket) {
+	if (bucket < 2 * subBucketCount)
+		return bucket;
+	int shift = bucket / subBucketCount - 1;
+	__int64 subBucket = bucket - shift * subBucketCount;
+	return ((subBucket + 1) << shift) - 1;
+}
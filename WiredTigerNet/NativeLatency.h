@@ -0,0 +1,56 @@
+#pragma once
+#include "NativeClock.h"
+#include <string>
+#include <vector>
+
+enum NativeLatencyOp {
+	NativeLatencySearch,
+	NativeLatencySearchNear,
+	NativeLatencyNext,
+	NativeLatencyPrev,
+	NativeLatencyInsert,
+	NativeLatencyRemove,
+	NativeLatencyModify,
+	NativeLatencyOpCount
+};
+
+// Log-linear buckets with 16 sub-buckets per power of two, so a bucket is at most 1/16 of its value wide
+const int latencyBucketCount = 576;
+
+struct NativeLatencySnapshot {
+	std::string table;
+	NativeLatencyOp op;
+	__int64 count;
+	__int64 totalNanoseconds;
+	__int64 maxNanoseconds;
+	std::vector<__int64> buckets;
+};
+
+// Latencies are recorded into per-thread histograms without locks and merged by SnapshotLatency.
+// Tracking is global and off by default, while it is off recording costs a flag check.
+void SetLatencyTracking(bool enabled);
+bool IsLatencyTracking();
+// Returns a small id of a table name for RecordLatency
+int InternLatencyTable(const char* name);
+void RecordLatency(int table, NativeLatencyOp op, __int64 ticks);
+// Appends merged histograms of every table and op that recorded anything since the process start
+void SnapshotLatency(std::vector<NativeLatencySnapshot>& out);
+// Highest nanosecond value that falls into bucket
+__int64 LatencyBucketUpperBound(int bucket);
+
+class LatencyScope {
+public:
+	// a negative table records nothing
+	LatencyScope(int table, NativeLatencyOp op) : table_(table), op_(op), start_(table >= 0 && IsLatencyTracking() ? NativeClockTicks() : 0) {
+	}
+	~LatencyScope() {
+		if (start_ != 0)
+			RecordLatency(table_, op_, NativeClockTicks() - start_);
+	}
+private:
+	LatencyScope(const LatencyScope&);
+	LatencyScope& operator=(const LatencyScope&);
+	int table_;
+	NativeLatencyOp op_;
+	__int64 start_;
+};
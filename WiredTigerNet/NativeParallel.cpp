@@ -0,0 +1,525 @@
+#include "NativeParallel.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <thread>
+
+namespace {
+	// more partitions than threads let threads that finish early help with skewed partitions
+	const int partitionsPerThread = 4;
+	// samples per part, SampleSplitKeys draws up to samplesMaxDraws times as many when few fall within the range
+	const int samplesPerPart = 32;
+	const int samplesMaxDraws = 16;
+	const int scanBatchRows = 1024;
+	const int scanBatchBytes = 256 * 1024;
+
+	Byte* LeftOf(const NativeRange& range) {
+		return range.hasLeft ? (Byte*)range.left.data() : nullptr;
+	}
+
+	Byte* RightOf(const NativeRange& range) {
+		return range.hasRight ? (Byte*)range.right.data() : nullptr;
+	}
+
+	bool Contains(NativeCursor* cursor, const NativeRange& range) {
+		return cursor->Contains(LeftOf(range), (int)range.left.size(), range.leftInclusive,
+			RightOf(range), (int)range.right.size(), range.rightInclusive);
+	}
+
+	class SessionScope {
+	public:
+		SessionScope(WT_CONNECTION* connection) {
+			int r = connection->open_session(connection, nullptr, nullptr, &session_);
+			if (r != 0)
+				throw NativeWiredTigerApiException(r, "connection->open_session");
+		}
+		~SessionScope() {
+			session_->close(session_, nullptr);
+		}
+		WT_SESSION* Session() const { return session_; }
+	private:
+		SessionScope(const SessionScope&);
+		SessionScope& operator=(const SessionScope&);
+		WT_SESSION* session_;
+	};
+
+	void Partition(WT_CONNECTION* connection, const char* uri, const NativeRange& range, int threads, std::vector<NativeRange>& parts) {
+		std::vector<std::vector<Byte>> splits;
+		if (threads > 1) {
+			SessionScope session(connection);
+			SampleSplitKeys(session.Session(), uri, range, threads * partitionsPerThread, false, splits);
+		}
+		SplitRange(range, splits, parts);
+	}
+
+	// Partitions are dealt to threads in contiguous runs. A thread takes its own from the front and steals
+	// from the back of the others, so owners and thieves rarely contend for the same deque.
+	class PartitionDeques {
+	public:
+		PartitionDeques(int partitions, int threads) : deques_(threads), mutexes_(threads) {
+			for (int i = 0; i < partitions; i++)
+				deques_[(size_t)i * threads / partitions].push_back(i);
+		}
+		bool Take(int thread, int* partition) {
+			{
+				std::lock_guard<std::mutex> lock(mutexes_[thread]);
+				if (!deques_[thread].empty()) {
+					*partition = deques_[thread].front();
+					deques_[thread].pop_front();
+					return true;
+				}
+			}
+			for (size_t i = 1; i < deques_.size(); i++) {
+				size_t victim = (thread + i) % deques_.size();
+				std::lock_guard<std::mutex> lock(mutexes_[victim]);
+				if (!deques_[victim].empty()) {
+					*partition = deques_[victim].back();
+					deques_[victim].pop_back();
+					return true;
+				}
+			}
+			return false;
+		}
+	private:
+		PartitionDeques(const PartitionDeques&);
+		PartitionDeques& operator=(const PartitionDeques&);
+		std::vector<std::deque<int>> deques_;
+		std::vector<std::mutex> mutexes_;
+	};
+
+	// The first failure of any thread
+	class Failure {
+	public:
+		Failure() : failed_(false), errorCode_(0) {
+		}
+		void Set(int errorCode, const std::string& apiName) {
+			std::lock_guard<std::mutex> lock(mutex_);
+			if (failed_)
+				return;
+			errorCode_ = errorCode;
+			apiName_ = apiName;
+			failed_ = true;
+		}
+		bool Failed() {
+			std::lock_guard<std::mutex> lock(mutex_);
+			return failed_;
+		}
+		void Rethrow() {
+			std::lock_guard<std::mutex> lock(mutex_);
+			if (failed_)
+				throw NativeWiredTigerApiException(errorCode_, apiName_);
+		}
+	private:
+		std::mutex mutex_;
+		bool failed_;
+		int errorCode_;
+		std::string apiName_;
+	};
+
+	struct KeySample {
+		std::vector<Byte> key;
+		__int64 weight;
+
+		bool operator<(const KeySample& other) const {
+			return key < other.key;
+		}
+	};
+
+	void AddSample(NativeCursor* cursor, bool balanceBytes, std::vector<KeySample>& samples) {
+		NativeBytes key = cursor->KeyView();
+		KeySample sample;
+		sample.key.assign(key.data, key.data + key.size);
+		sample.weight = 1;
+		if (balanceBytes)
+			sample.weight = key.size + (cursor->ValueFormat()[0] != 0 ? cursor->ValueView().size : 0);
+		samples.push_back(sample);
+	}
+
+	// Returns false when the table has more than maxEntries entries or the statistic is not available
+	bool IsSmallTable(WT_SESSION* session, const char* uri, __int64 maxEntries) {
+		const int key = WT_STAT_DSRC_BTREE_ENTRIES;
+		__int64 entries = 0;
+		try {
+			ReadStatistics(session, uri, nullptr, &key, 1, &entries);
+		}
+		catch (const NativeWiredTigerApiException&) {
+			return false;
+		}
+		// entries are zero when the database does not collect tree walk statistics
+		return entries > 0 && entries <= maxEntries;
+	}
+
+	struct ScanBatch {
+		std::vector<Byte> data;
+		std::vector<int> offsets;
+		int rows;
+	};
+}
+
+void SampleSplitKeys(WT_SESSION* session, const char* uri, const NativeRange& range, int parts, bool balanceBytes,
+	std::vector<std::vector<Byte>>& splits) {
+	splits.clear();
+	if (parts < 2)
+		return;
+	int samples = parts * samplesPerPart;
+	int maxDraws = samples * samplesMaxDraws;
+	std::vector<KeySample> keys;
+	if (IsSmallTable(session, uri, maxDraws)) {
+		// every key of the range is cheaper than random descents and gives exact splits
+		std::unique_ptr<NativeCursor> cursor(OpenNativeCursor(session, uri, nullptr));
+		if (cursor->IterationBegin(LeftOf(range), (int)range.left.size(), range.leftInclusive,
+			RightOf(range), (int)range.right.size(), range.rightInclusive, Ascending, false))
+			do {
+				AddSample(cursor.get(), balanceBytes, keys);
+			} while (cursor->IterationMove());
+	}
+	else {
+		std::string config = "next_random=true,next_random_sample_size=" + std::to_string(maxDraws);
+		std::unique_ptr<NativeCursor> random(OpenNativeCursor(session, uri, config.c_str()));
+		for (int i = 0; i < maxDraws && (int)keys.size() < samples; i++) {
+			// the table is empty
+			if (!random->Next())
+				return;
+			if (Contains(random.get(), range))
+				AddSample(random.get(), balanceBytes, keys);
+		}
+	}
+	// vectors of bytes compare as unsigned bytes, in the order of WiredTiger keys
+	std::sort(keys.begin(), keys.end());
+	__int64 total = 0;
+	for (size_t i = 0; i < keys.size(); i++)
+		total += keys[i].weight;
+	// split i is the first key with at least i / parts of the total weight before it
+	__int64 before = 0;
+	int next = 1;
+	for (size_t i = 0; i < keys.size() && next < parts; i++) {
+		if (i > 0 && before * parts >= total * next && keys[i].key != keys[i - 1].key) {
+			splits.push_back(keys[i].key);
+			while (next < parts && before * parts >= total * next)
+				next++;
+		}
+		before += keys[i].weight;
+	}
+}
+
+void SplitRange(const NativeRange& range, const std::vector<std::vector<Byte>>& splits, std::vector<NativeRange>& parts) {
+	parts.clear();
+	NativeRange part = range;
+	for (size_t i = 0; i < splits.size(); i++) {
+		part.hasRight = true;
+		part.right = splits[i];
+		part.rightInclusive = false;
+		parts.push_back(part);
+		part.hasLeft = true;
+		part.left = splits[i];
+		part.leftInclusive = true;
+	}
+	part.hasRight = range.hasRight;
+	part.right = range.right;
+	part.rightInclusive = range.rightInclusive;
+	parts.push_back(part);
+}
+
+__int64 ParallelCount(WT_CONNECTION* connection, const char* uri, const char* cursorConfig, const NativeRange& range, int threads) {
+	std::vector<NativeRange> parts;
+	Partition(connection, uri, range, threads, parts);
+	PartitionDeques work((int)parts.size(), threads);
+	std::atomic<__int64> total(0);
+	Failure failure;
+	std::vector<std::thread> workers;
+	auto run = [&](int thread) {
+		try {
+			SessionScope session(connection);
+			std::unique_ptr<NativeCursor> cursor(OpenNativeCursor(session.Session(), uri, cursorConfig));
+			int part;
+			while (!failure.Failed() && work.Take(thread, &part)) {
+				const NativeRange& r = parts[part];
+				total += cursor->GetTotalCount(LeftOf(r), (int)r.left.size(), r.leftInclusive,
+					RightOf(r), (int)r.right.size(), r.rightInclusive, LLONG_MAX);
+				cursor->Reset();
+			}
+		}
+		catch (const NativeWiredTigerApiException& e) {
+			failure.Set(e.ErrorCode(), e.ApiName());
+		}
+		catch (const std::bad_alloc&) {
+			failure.Set(ENOMEM, "ParallelCount");
+		}
+	};
+	try {
+		for (int i = 0; i < threads; i++)
+			workers.push_back(std::thread(run, i));
+	}
+	catch (const std::system_error&) {
+		// the threads already running steal the partitions of those that failed to start
+		if (workers.empty())
+			throw;
+	}
+	for (size_t i = 0; i < workers.size(); i++)
+		workers[i].join();
+	failure.Rethrow();
+	return total;
+}
+
+// *************
+// NativeParallelScan
+// *************
+
+struct NativeParallelScan::State {
+	WT_CONNECTION* connection;
+	std::string uri;
+	bool hasCursorConfig;
+	std::string cursorConfig;
+	bool ordered;
+	size_t maxQueued;
+	std::vector<NativeRange> parts;
+	// unordered scans steal partitions, ordered scans claim them in key order
+	std::unique_ptr<PartitionDeques> work;
+	std::atomic<int> nextPart;
+	std::vector<std::thread> threads;
+
+	std::mutex mutex;
+	std::condition_variable produced;
+	std::condition_variable consumed;
+	// ordered scans queue batches per partition, unordered scans share the first queue
+	std::vector<std::deque<ScanBatch*>> queues;
+	std::vector<bool> finished;
+	// the partition ordered scans deliver
+	size_t current;
+	int running;
+	bool stopping;
+	bool failed;
+	int errorCode;
+	std::string apiName;
+
+	// owned by the consumer
+	std::unique_ptr<ScanBatch> batch;
+	int position;
+
+	bool Take(int thread, int* part) {
+		if (!ordered)
+			return work->Take(thread, part);
+		int next = nextPart++;
+		if (next >= (int)parts.size())
+			return false;
+		*part = next;
+		return true;
+	}
+
+	// Returns false when the scan is stopping
+	bool Push(int part, ScanBatch* batch) {
+		std::deque<ScanBatch*>& queue = queues[ordered ? part : 0];
+		std::unique_lock<std::mutex> lock(mutex);
+		consumed.wait(lock, [&]() { return stopping || queue.size() < maxQueued; });
+		if (stopping)
+			return false;
+		queue.push_back(batch);
+		produced.notify_one();
+		return true;
+	}
+
+	void Finish(int part) {
+		std::lock_guard<std::mutex> lock(mutex);
+		if (ordered)
+			finished[part] = true;
+		produced.notify_one();
+	}
+
+	void Fail(int code, const std::string& api) {
+		std::lock_guard<std::mutex> lock(mutex);
+		if (!failed) {
+			failed = true;
+			errorCode = code;
+			apiName = api;
+		}
+		stopping = true;
+		produced.notify_all();
+		consumed.notify_all();
+	}
+
+	// Waits for the next batch when wait is set, returns nullptr once the scan is complete
+	ScanBatch* Pop(bool wait) {
+		std::unique_lock<std::mutex> lock(mutex);
+		while (true) {
+			if (failed)
+				throw NativeWiredTigerApiException(errorCode, apiName);
+			if (ordered) {
+				while (current < queues.size() && queues[current].empty() && finished[current])
+					current++;
+				if (current == queues.size())
+					return nullptr;
+			}
+			std::deque<ScanBatch*>& queue = queues[ordered ? current : 0];
+			if (!queue.empty()) {
+				ScanBatch* result = queue.front();
+				queue.pop_front();
+				consumed.notify_all();
+				return result;
+			}
+			if (!ordered && running == 0)
+				return nullptr;
+			if (!wait)
+				return nullptr;
+			produced.wait(lock);
+		}
+	}
+
+	// Returns false when the scan is stopping
+	bool ScanPart(NativeCursor* cursor, int part) {
+		const NativeRange& r = parts[part];
+		if (!cursor->IterationBegin(LeftOf(r), (int)r.left.size(), r.leftInclusive,
+			RightOf(r), (int)r.right.size(), r.rightInclusive, Ascending, false))
+			return true;
+		while (true) {
+			std::unique_ptr<ScanBatch> next(new ScanBatch());
+			next->data.resize(scanBatchBytes);
+			next->offsets.resize(2 * scanBatchRows + 1);
+			int requiredSize;
+			next->rows = cursor->FetchBatch(next->data.data(), (int)next->data.size(), next->offsets.data(), scanBatchRows, &requiredSize);
+			if (next->rows == 0 && requiredSize > 0) {
+				next->data.resize(requiredSize);
+				next->rows = cursor->FetchBatch(next->data.data(), (int)next->data.size(), next->offsets.data(), scanBatchRows, &requiredSize);
+			}
+			if (next->rows == 0)
+				return true;
+			if (!Push(part, next.get()))
+				return false;
+			next.release();
+		}
+	}
+
+	void Run(int thread) {
+		try {
+			SessionScope session(connection);
+			std::unique_ptr<NativeCursor> cursor(OpenNativeCursor(session.Session(), uri.c_str(),
+				hasCursorConfig ? cursorConfig.c_str() : nullptr));
+			int part;
+			while (Take(thread, &part)) {
+				if (!ScanPart(cursor.get(), part))
+					break;
+				cursor->Reset();
+				Finish(part);
+			}
+		}
+		catch (const NativeWiredTigerApiException& e) {
+			Fail(e.ErrorCode(), e.ApiName());
+		}
+		catch (const std::bad_alloc&) {
+			Fail(ENOMEM, "NativeParallelScan");
+		}
+		std::lock_guard<std::mutex> lock(mutex);
+		running--;
+		produced.notify_one();
+	}
+
+	void Stop() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+			produced.notify_all();
+			consumed.notify_all();
+		}
+		for (size_t i = 0; i < threads.size(); i++)
+			threads[i].join();
+		threads.clear();
+		for (size_t i = 0; i < queues.size(); i++) {
+			for (size_t j = 0; j < queues[i].size(); j++)
+				delete queues[i][j];
+			queues[i].clear();
+		}
+	}
+};
+
+NativeParallelScan::NativeParallelScan(WT_CONNECTION* connection, const char* uri, const char* cursorConfig, const NativeRange& range,
+	int threads, bool ordered, int maxQueuedBatches) {
+	std::unique_ptr<State> state(new State());
+	state->connection = connection;
+	state->uri = uri;
+	state->hasCursorConfig = cursorConfig != nullptr;
+	if (cursorConfig != nullptr)
+		state->cursorConfig = cursorConfig;
+	state->ordered = ordered;
+	state->maxQueued = std::max(maxQueuedBatches, 1);
+	Partition(connection, uri, range, threads, state->parts);
+	if (ordered) {
+		state->queues.resize(state->parts.size());
+		state->finished.assign(state->parts.size(), false);
+	}
+	else {
+		state->queues.resize(1);
+		// the consumer keeps up with all threads through one queue
+		state->maxQueued *= threads;
+		state->work.reset(new PartitionDeques((int)state->parts.size(), threads));
+	}
+	state->nextPart = 0;
+	state->current = 0;
+	state->running = 0;
+	state->stopping = false;
+	state->failed = false;
+	state->errorCode = 0;
+	state->position = 0;
+	try {
+		for (int i = 0; i < threads; i++) {
+			{
+				std::lock_guard<std::mutex> lock(state->mutex);
+				state->running++;
+			}
+			try {
+				state->threads.push_back(std::thread(&State::Run, state.get(), i));
+			}
+			catch (...) {
+				std::lock_guard<std::mutex> lock(state->mutex);
+				state->running--;
+				throw;
+			}
+		}
+	}
+	catch (const std::system_error&) {
+		// unordered scans leave the partitions of missing threads to the others, ordered ones claim them anyway
+		if (state->threads.empty())
+			throw;
+	}
+	state_ = state.release();
+}
+
+NativeParallelScan::~NativeParallelScan() {
+	state_->Stop();
+	delete state_;
+}
+
+int NativeParallelScan::FetchBatch(Byte* buffer, int bufferSize, int* offsets, int maxRows, int* requiredSize) {
+	State* s = state_;
+	int rows = 0;
+	int used = 0;
+	*requiredSize = 0;
+	offsets[0] = 0;
+	while (rows < maxRows) {
+		if (!s->batch || s->position == s->batch->rows) {
+			// wait only while nothing is packed, rows at hand are returned without waiting for more
+			s->batch.reset(s->Pop(rows == 0));
+			s->position = 0;
+			if (!s->batch)
+				break;
+		}
+		const int* row = s->batch->offsets.data() + 2 * s->position;
+		int rowSize = row[2] - row[0];
+		if (rowSize > bufferSize - used) {
+			if (rows == 0)
+				*requiredSize = rowSize;
+			break;
+		}
+		memcpy(buffer + used, s->batch->data.data() + row[0], rowSize);
+		offsets[2 * rows + 1] = used + row[1] - row[0];
+		used += rowSize;
+		offsets[2 * rows + 2] = used;
+		rows++;
+		s->position++;
+	}
+	return rows;
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include "NativeTiger.h"
+
+// Returns at most parts - 1 distinct split keys of uri within range in ascending order, so that about as many keys,
+// or with balanceBytes as many key and value bytes, fall between neighbouring splits. Keys are sampled with
+// a next_random cursor, unless the entries statistic shows the table is small enough to walk the range instead.
+// Fewer splits are returned for small or empty ranges.
+void SampleSplitKeys(WT_SESSION* session, const char* uri, const NativeRange& range, int parts, bool balanceBytes,
+	std::vector<std::vector<Byte>>& splits);
+
+// Cuts range at splits, split i becomes the inclusive left boundary of part i + 1
+void SplitRange(const NativeRange& range, const std::vector<std::vector<Byte>>& splits, std::vector<NativeRange>& parts);
+
+// Counts keys of range on threads sessions of connection. The range is split into partitions by sampling,
+// threads start with neighbouring partitions and steal from each other when they run out.
+// Every thread reads its own snapshot.
+__int64 ParallelCount(WT_CONNECTION* connection, const char* uri, const char* cursorConfig, const NativeRange& range, int threads);
+
+// Scans range on threads sessions of connection, handing rows to a single consumer in batches. Unordered scans
+// deliver partitions as they are read, partitions are distributed as in ParallelCount. Ordered scans claim
+// partitions in key order and deliver them in that order, buffering at most maxQueuedBatches batches per partition.
+class NativeParallelScan {
+public:
+	NativeParallelScan(WT_CONNECTION* connection, const char* uri, const char* cursorConfig, const NativeRange& range,
+		int threads, bool ordered, int maxQueuedBatches);
+	// Stops the threads, remaining rows are discarded
+	~NativeParallelScan();
+	// Same contract as NativeCursor::FetchBatch, waits for rows when none are buffered. Returns 0 with requiredSize 0
+	// once the scan is complete, a failure of any thread is thrown here.
+	int FetchBatch(Byte* buffer, int bufferSize, int* offsets, int maxRows, int* requiredSize);
+private:
+	struct State;
+	NativeParallelScan(const NativeParallelScan&);
+	NativeParallelScan& operator=(const NativeParallelScan&);
+	State* state_;
+};
@@ -0,0 +1,104 @@
+#include "NativeProgress.h"
+#include "NativeClock.h"
+#include <map>
+#include <mutex>
+
+// *************
+// NativeProgressLimiter
+// *************
+
+// Entries are pruned once the map grows past this, all of them if pruning expired ones is not enough
+static const size_t progressLimiterMaxEntries = 1024;
+
+struct NativeProgressLimiter::State {
+	std::mutex mutex;
+	__int64 intervalTicks;
+	std::map<std::pair<WT_SESSION*, std::string>, __int64> lastReports;
+	// size at which the next prune runs
+	size_t pruneAt;
+
+	// An entry older than the interval admits the next report just as a missing one does, so dropping it changes
+	// nothing. Doubling pruneAt keeps pruning amortized when many sessions report within one interval.
+	void Prune(__int64 now) {
+		std::map<std::pair<WT_SESSION*, std::string>, __int64>::iterator it = lastReports.begin();
+		while (it != lastReports.end()) {
+			if (now - it->second >= intervalTicks)
+				it = lastReports.erase(it);
+			else
+				++it;
+		}
+		if (lastReports.size() > progressLimiterMaxEntries)
+			lastReports.clear();
+		pruneAt = lastReports.size() * 2 < 64 ? 64 : lastReports.size() * 2;
+	}
+};
+
+NativeProgressLimiter::NativeProgressLimiter(int intervalMilliseconds) : state_(new State()) {
+	state_->intervalTicks = NativeClockFrequency() * intervalMilliseconds / 1000;
+	state_->pruneAt = 64;
+}
+
+NativeProgressLimiter::~NativeProgressLimiter() {
+	delete state_;
+}
+
+bool NativeProgressLimiter::Admit(WT_SESSION* session, const char* operation) {
+	__int64 now = NativeClockTicks();
+	std::pair<WT_SESSION*, std::string> key(session, operation == nullptr ? "" : operation);
+	std::lock_guard<std::mutex> lock(state_->mutex);
+	std::map<std::pair<WT_SESSION*, std::string>, __int64>::iterator it = state_->lastReports.find(key);
+	if (it == state_->lastReports.end()) {
+		if (state_->lastReports.size() >= state_->pruneAt)
+			state_->Prune(now);
+		state_->lastReports.insert(std::make_pair(key, now));
+		return true;
+	}
+	if (now - it->second < state_->intervalTicks)
+		return false;
+	it->second = now;
+	return true;
+}
+
+// *************
+// NativeEventHandler
+// *************
+
+struct NativeEventHandler::State {
+	// WiredTiger passes the handler back to the callbacks, so the state is found through it
+	struct Handler {
+		WT_EVENT_HANDLER base;
+		State* state;
+	};
+
+	Handler handler;
+	NativeProgressCallback progress;
+	NativeProgressLimiter limiter;
+
+	State(int progressIntervalMilliseconds) : limiter(progressIntervalMilliseconds) {
+	}
+
+	static int HandleProgress(WT_EVENT_HANDLER* handler, WT_SESSION* session, const char* operation, uint64_t progress) {
+		State* state = reinterpret_cast<Handler*>(handler)->state;
+		if (!state->limiter.Admit(session, operation))
+			return 0;
+		return state->progress(operation, progress);
+	}
+};
+
+NativeEventHandler::NativeEventHandler(NativeErrorCallback error, NativeMessageCallback message,
+	NativeProgressCallback progress, int progressIntervalMilliseconds) : state_(new State(progressIntervalMilliseconds)) {
+	state_->progress = progress;
+	state_->handler.base.handle_error = error;
+	state_->handler.base.handle_message = message;
+	state_->handler.base.handle_progress = progress == nullptr ? nullptr : &State::HandleProgress;
+	state_->handler.base.handle_close = nullptr;
+	state_->handler.state = state_;
+}
+
+NativeEventHandler::~NativeEventHandler() {
+	delete state_;
+}
+
+WT_EVENT_HANDLER* NativeEventHandler::Handler() {
+	return &state_->handler.base;
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include "NativeTiger.h"
+
+// Passes through the first progress report of an operation in a session and then
+// at most one report per interval, so long operations do not flood the handler.
+// Sessions are only known by address, so state older than the interval is dropped as sessions come and go,
+// and a new session at the address of a closed one waits at most one interval for its first report.
+class NativeProgressLimiter {
+public:
+	explicit NativeProgressLimiter(int intervalMilliseconds);
+	~NativeProgressLimiter();
+	bool Admit(WT_SESSION* session, const char* operation);
+private:
+	struct State;
+	NativeProgressLimiter(const NativeProgressLimiter&);
+	NativeProgressLimiter& operator=(const NativeProgressLimiter&);
+	State* state_;
+};
+
+typedef int(*NativeErrorCallback)(WT_EVENT_HANDLER* handler, WT_SESSION* session, int error, const char* message);
+typedef int(*NativeMessageCallback)(WT_EVENT_HANDLER* handler, WT_SESSION* session, const char* message);
+typedef int(*NativeProgressCallback)(const char* operation, unsigned __int64 progress);
+
+// Event handler for wiredtiger_open calling back directly on WiredTiger threads,
+// progress reports are throttled before they reach progress, which may be null
+class NativeEventHandler {
+public:
+	NativeEventHandler(NativeErrorCallback error, NativeMessageCallback message,
+		NativeProgressCallback progress, int progressIntervalMilliseconds);
+	~NativeEventHandler();
+	// Valid for the lifetime of this object, which must outlive the connection
+	WT_EVENT_HANDLER* Handler();
+private:
+	struct State;
+	NativeEventHandler(const NativeEventHandler&);
+	NativeEventHandler& operator=(const NativeEventHandler&);
+	State* state_;
+};
@@ -0,0 +1,285 @@
+#include "NativeRanges.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+	// vectors of bytes compare as unsigned bytes, in the order of WiredTiger keys
+	int CompareKeys(const std::vector<Byte>& a, const std::vector<Byte>& b) {
+		if (a < b)
+			return -1;
+		return b < a ? 1 : 0;
+	}
+
+	// Orders ranges by the first key they may hold
+	bool StartsBefore(const NativeRange& a, const NativeRange& b) {
+		if (!a.hasLeft || !b.hasLeft)
+			return !a.hasLeft && b.hasLeft;
+		int result = CompareKeys(a.left, b.left);
+		if (result != 0)
+			return result < 0;
+		return a.leftInclusive && !b.leftInclusive;
+	}
+
+	// Orders ranges by the last key they may hold
+	bool EndsAfter(const NativeRange& a, const NativeRange& b) {
+		if (!a.hasRight || !b.hasRight)
+			return !a.hasRight && b.hasRight;
+		int result = CompareKeys(a.right, b.right);
+		if (result != 0)
+			return result > 0;
+		return a.rightInclusive && !b.rightInclusive;
+	}
+
+	// Whether b, which does not start before a, overlaps or touches a, so that their union is one range
+	bool Touches(const NativeRange& a, const NativeRange& b) {
+		if (!a.hasRight || !b.hasLeft)
+			return true;
+		int result = CompareKeys(b.left, a.right);
+		return result < 0 || result == 0 && (a.rightInclusive || b.leftInclusive);
+	}
+
+	int CompareBounds(const NativeBound& a, const NativeBound& b) {
+		int size = a.size < b.size ? a.size : b.size;
+		int result = size > 0 ? memcmp(a.data, b.data, size) : 0;
+		if (result == 0 && a.size != b.size)
+			result = a.size < b.size ? -1 : 1;
+		return result;
+	}
+
+	// Order left boundaries by the first key and right boundaries by the last key of their range
+	bool LeftBefore(const NativeBound& a, const NativeBound& b) {
+		if (!a.bounded || !b.bounded)
+			return !a.bounded && b.bounded;
+		int result = CompareBounds(a, b);
+		if (result != 0)
+			return result < 0;
+		return a.inclusive && !b.inclusive;
+	}
+
+	bool RightBefore(const NativeBound& a, const NativeBound& b) {
+		if (!a.bounded || !b.bounded)
+			return a.bounded && !b.bounded;
+		int result = CompareBounds(a, b);
+		if (result != 0)
+			return result < 0;
+		return !a.inclusive && b.inclusive;
+	}
+
+	bool IsEmpty(const NativeBound& left, const NativeBound& right) {
+		if (!left.bounded || !right.bounded)
+			return false;
+		int result = CompareBounds(left, right);
+		return result > 0 || result == 0 && !(left.inclusive && right.inclusive);
+	}
+
+	// Whether a range starting at left touches or overlaps a range ending at right that does not start after it
+	bool Touches(const NativeBound& right, const NativeBound& left) {
+		if (!right.bounded || !left.bounded)
+			return true;
+		int result = CompareBounds(left, right);
+		return result < 0 || result == 0 && (right.inclusive || left.inclusive);
+	}
+
+	// The boundary on the other side of the same key, the complement starts where a range ends
+	NativeBound Flip(const NativeBound& bound) {
+		NativeBound result = bound;
+		result.inclusive = !bound.inclusive;
+		return result;
+	}
+
+	const NativeBound unbounded = { false, false, nullptr, 0 };
+
+	NativeBound ToBound(bool bounded, const std::vector<Byte>& bytes, bool inclusive) {
+		NativeBound result = { bounded, inclusive, bytes.data(), (int)bytes.size() };
+		return result;
+	}
+}
+
+NativeRange MakeNativeRange(const Byte* left, int leftSize, bool leftInclusive, const Byte* right, int rightSize, bool rightInclusive) {
+	NativeRange result;
+	result.hasLeft = left != nullptr;
+	if (result.hasLeft)
+		result.left.assign(left, left + leftSize);
+	result.leftInclusive = leftInclusive;
+	result.hasRight = right != nullptr;
+	if (result.hasRight)
+		result.right.assign(right, right + rightSize);
+	result.rightInclusive = rightInclusive;
+	return result;
+}
+
+bool IsEmptyRange(const NativeRange& range) {
+	if (!range.hasLeft || !range.hasRight)
+		return false;
+	int result = CompareKeys(range.left, range.right);
+	return result > 0 || result == 0 && !(range.leftInclusive && range.rightInclusive);
+}
+
+void NormalizeRanges(std::vector<NativeRange>& ranges) {
+	ranges.erase(std::remove_if(ranges.begin(), ranges.end(), IsEmptyRange), ranges.end());
+	std::stable_sort(ranges.begin(), ranges.end(), StartsBefore);
+	size_t merged = 0;
+	for (size_t i = 0; i < ranges.size(); i++) {
+		if (i > 0 && Touches(ranges[merged - 1], ranges[i])) {
+			NativeRange& last = ranges[merged - 1];
+			if (EndsAfter(ranges[i], last)) {
+				last.hasRight = ranges[i].hasRight;
+				last.right.swap(ranges[i].right);
+				last.rightInclusive = ranges[i].rightInclusive;
+			}
+			continue;
+		}
+		if (merged != i)
+			ranges[merged] = std::move(ranges[i]);
+		merged++;
+	}
+	ranges.resize(merged);
+}
+
+// *************
+// NativeRangeSet
+// *************
+
+NativeRangeSet::NativeRangeSet() {
+}
+
+NativeRangeSet::NativeRangeSet(const std::vector<NativeRange>& ranges) {
+	std::vector<NativeRange> normalized(ranges);
+	NormalizeRanges(normalized);
+	bounds_.reserve(2 * normalized.size());
+	size_t size = 0;
+	for (size_t i = 0; i < normalized.size(); i++)
+		size += normalized[i].left.size() + normalized[i].right.size();
+	bytes_.reserve(size);
+	for (size_t i = 0; i < normalized.size(); i++) {
+		const NativeRange& range = normalized[i];
+		Append(ToBound(range.hasLeft, range.left, range.leftInclusive), ToBound(range.hasRight, range.right, range.rightInclusive));
+	}
+}
+
+NativeBound NativeRangeSet::View(const Bound& bound) const {
+	NativeBound result = { bound.bounded, bound.inclusive, bytes_.data() + bound.offset, bound.size };
+	return result;
+}
+
+NativeBound NativeRangeSet::Left(int index) const {
+	return View(bounds_[2 * index]);
+}
+
+NativeBound NativeRangeSet::Right(int index) const {
+	return View(bounds_[2 * index + 1]);
+}
+
+NativeRange NativeRangeSet::Get(int index) const {
+	// an empty key may have no storage, so the boundaries are not passed as pointers
+	NativeBound left = Left(index);
+	NativeBound right = Right(index);
+	NativeRange result;
+	result.hasLeft = left.bounded;
+	result.left.assign(left.data, left.data + left.size);
+	result.leftInclusive = left.inclusive;
+	result.hasRight = right.bounded;
+	result.right.assign(right.data, right.data + right.size);
+	result.rightInclusive = right.inclusive;
+	return result;
+}
+
+bool NativeRangeSet::Contains(const Byte* key, int size) const {
+	NativeBound point = { true, true, key, size };
+	// the first range starting after key
+	int low = 0;
+	int high = Count();
+	while (low < high) {
+		int middle = (low + high) / 2;
+		if (LeftBefore(point, Left(middle)))
+			high = middle;
+		else
+			low = middle + 1;
+	}
+	return low > 0 && !RightBefore(Right(low - 1), point);
+}
+
+void NativeRangeSet::Clear() {
+	bounds_.clear();
+	bytes_.clear();
+}
+
+void NativeRangeSet::Swap(NativeRangeSet& other) {
+	bounds_.swap(other.bounds_);
+	bytes_.swap(other.bytes_);
+}
+
+void NativeRangeSet::AppendBound(const NativeBound& bound) {
+	Bound stored = { (int)bytes_.size(), bound.bounded ? bound.size : 0, bound.bounded, bound.inclusive };
+	if (bound.bounded)
+		bytes_.insert(bytes_.end(), bound.data, bound.data + bound.size);
+	bounds_.push_back(stored);
+}
+
+void NativeRangeSet::Append(const NativeBound& left, const NativeBound& right) {
+	if (IsEmpty(left, right))
+		return;
+	if (!bounds_.empty() && Touches(Right(Count() - 1), left)) {
+		if (RightBefore(Right(Count() - 1), right)) {
+			// the right boundary of the last range is the tail of the buffer
+			bytes_.resize(bounds_.back().offset);
+			bounds_.pop_back();
+			AppendBound(right);
+		}
+		return;
+	}
+	AppendBound(left);
+	AppendBound(right);
+}
+
+void NativeRangeSet::Union(const NativeRangeSet& a, const NativeRangeSet& b, NativeRangeSet& result) {
+	result.Clear();
+	int i = 0;
+	int j = 0;
+	while (i < a.Count() || j < b.Count()) {
+		if (j == b.Count() || i < a.Count() && !LeftBefore(b.Left(j), a.Left(i))) {
+			result.Append(a.Left(i), a.Right(i));
+			i++;
+		}
+		else {
+			result.Append(b.Left(j), b.Right(j));
+			j++;
+		}
+	}
+}
+
+void NativeRangeSet::Intersect(const NativeRangeSet& a, const NativeRangeSet& b, NativeRangeSet& result) {
+	result.Clear();
+	int i = 0;
+	int j = 0;
+	while (i < a.Count() && j < b.Count()) {
+		NativeBound left = LeftBefore(a.Left(i), b.Left(j)) ? b.Left(j) : a.Left(i);
+		bool aEndsFirst = !RightBefore(b.Right(j), a.Right(i));
+		result.Append(left, aEndsFirst ? a.Right(i) : b.Right(j));
+		if (aEndsFirst)
+			i++;
+		else
+			j++;
+	}
+}
+
+void NativeRangeSet::Difference(const NativeRangeSet& a, const NativeRangeSet& b, NativeRangeSet& result) {
+	NativeRangeSet complement;
+	Complement(b, complement);
+	Intersect(a, complement, result);
+}
+
+void NativeRangeSet::Complement(const NativeRangeSet& a, NativeRangeSet& result) {
+	result.Clear();
+	NativeBound left = unbounded;
+	for (int i = 0; i < a.Count(); i++) {
+		NativeBound start = a.Left(i);
+		if (start.bounded)
+			result.Append(left, Flip(start));
+		NativeBound end = a.Right(i);
+		if (!end.bounded)
+			return;
+		left = Flip(end);
+	}
+	result.Append(left, unbounded);
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <vector>
+
+typedef unsigned char Byte;
+
+// A range with copied boundaries, a side without boundary is unbounded
+struct NativeRange {
+	bool hasLeft;
+	std::vector<Byte> left;
+	bool leftInclusive;
+	bool hasRight;
+	std::vector<Byte> right;
+	bool rightInclusive;
+};
+
+NativeRange MakeNativeRange(const Byte* left, int leftSize, bool leftInclusive, const Byte* right, int rightSize, bool rightInclusive);
+
+bool IsEmptyRange(const NativeRange& range);
+
+// Drops empty ranges, sorts the rest by their left boundaries and merges ranges that overlap or touch,
+// leaving disjoint ranges in key order
+void NormalizeRanges(std::vector<NativeRange>& ranges);
+
+// A boundary of a NativeRangeSet range, data points into the set and stays valid until the set changes
+struct NativeBound {
+	bool bounded;
+	bool inclusive;
+	const Byte* data;
+	int size;
+};
+
+// Disjoint ranges in key order that do not touch each other. Boundary bytes of all ranges share one buffer,
+// so a set takes two allocations however many ranges it holds, and set operations are linear merges.
+class NativeRangeSet {
+public:
+	NativeRangeSet();
+	explicit NativeRangeSet(const std::vector<NativeRange>& ranges);
+	int Count() const { return (int)bounds_.size() / 2; }
+	NativeBound Left(int index) const;
+	NativeBound Right(int index) const;
+	NativeRange Get(int index) const;
+	// Binary search for the range holding key
+	bool Contains(const Byte* key, int size) const;
+	// Keeps the buffers for reuse
+	void Clear();
+	void Swap(NativeRangeSet& other);
+	// result may not be one of the operands
+	static void Union(const NativeRangeSet& a, const NativeRangeSet& b, NativeRangeSet& result);
+	static void Intersect(const NativeRangeSet& a, const NativeRangeSet& b, NativeRangeSet& result);
+	static void Difference(const NativeRangeSet& a, const NativeRangeSet& b, NativeRangeSet& result);
+	static void Complement(const NativeRangeSet& a, NativeRangeSet& result);
+private:
+	struct Bound {
+		int offset;
+		int size;
+		bool bounded;
+		bool inclusive;
+	};
+	NativeBound View(const Bound& bound) const;
+	void AppendBound(const NativeBound& bound);
+	// Adds a range that does not start before the last one, merging them when they touch. Empty ranges are dropped.
+	void Append(const NativeBound& left, const NativeBound& right);
+	std::vector<Bound> bounds_;
+	std::vector<Byte> bytes_;
+};
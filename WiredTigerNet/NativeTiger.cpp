@@ -1,17 +1,43 @@
 #include "NativeTiger.h"
+#include "NativeLatency.h"
+#include "NativeRanges.h"
 #include <sstream>
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <thread>
 
 inline int min(int a, int b) {
 	return a < b ? a : b;
 }
 
+static int CompareBytes(const Byte* a, int aSize, const Byte* b, int bSize) {
+	int result = memcmp(a, b, min(aSize, bSize));
+	if (result == 0 && aSize != bSize)
+		result = aSize < bSize ? -1 : 1;
+	return result;
+}
+
 NativeCursor::NativeCursor(WT_CURSOR* cursor) :
 	cursor_(cursor),
+	keyIsString_(strcmp(cursor_->key_format, "S") == 0),
+	hasValue_(strcmp(cursor_->value_format, "") != 0),
+	hasCurrent_(false),
 	boundary_(nullptr),
-	keyIsString_(strcmp(cursor_->key_format, "S") == 0) {
+	ownsBoundary_(false),
+	latencyTable_(-1),
+	nextRange_(0) {
 }
 
 bool NativeCursor::IterationBegin(Byte* left, int leftSize, bool leftInclusive, Byte* right, int rightSize, bool rightInclusive, NativeDirection newDirection, bool copyBoundary) {
+	ranges_.Clear();
+	nextRange_ = 0;
+	// a failed begin leaves no current row and no boundary of a previous iteration
+	hasCurrent_ = false;
+	SetBoundary(nullptr, 0, false, false);
 	int exact;
 	if (newDirection == Ascending) {
 		if (left != nullptr) {
@@ -32,11 +58,71 @@ bool NativeCursor::IterationBegin(Byte* left, int leftSize, bool leftInclusive,
 		SetBoundary(left, leftSize, leftInclusive, copyBoundary);
 	}
 	direction_ = newDirection;
-	return Within();
+	hasCurrent_ = Within();
+	return hasCurrent_;
+}
+
+bool NativeCursor::IterationBegin(const std::vector<NativeRange>& ranges, NativeDirection newDirection) {
+	NativeRangeSet set(ranges);
+	return IterationBegin(set, newDirection);
+}
+
+bool NativeCursor::IterationBegin(const NativeRangeSet& ranges, NativeDirection newDirection) {
+	int r = Reset();
+	if (r != 0)
+		throw NativeWiredTigerApiException(r, "cursor->reset");
+	ranges_ = ranges;
+	nextRange_ = 0;
+	direction_ = newDirection;
+	hasCurrent_ = EnterRange(false);
+	return hasCurrent_;
+}
+
+// Moves to the first key of the remaining ranges. When positioned the cursor is on a key past the ranges
+// entered so far, so ranges up to that key are skipped and a range holding it is entered without a seek.
+bool NativeCursor::EnterRange(bool positioned) {
+	bool ascending = direction_ == Ascending;
+	while (nextRange_ < ranges_.Count()) {
+		int index = ascending ? nextRange_ : ranges_.Count() - 1 - nextRange_;
+		nextRange_++;
+		NativeBound start = ascending ? ranges_.Left(index) : ranges_.Right(index);
+		NativeBound end = ascending ? ranges_.Right(index) : ranges_.Left(index);
+		bool beforeStart = false;
+		if (positioned && start.bounded) {
+			int result = CompareKey(start.data, start.size);
+			if (!ascending)
+				result = -result;
+			beforeStart = result < 0 || result == 0 && !start.inclusive;
+		}
+		if (!positioned || beforeStart) {
+			int exact;
+			if (!start.bounded) {
+				if (!(ascending ? Next() : Prev()))
+					return false;
+			}
+			else if (!SearchNear((Byte*)start.data, start.size, &exact))
+				return false;
+			else if ((exact == 0 && !start.inclusive || (ascending ? exact < 0 : exact > 0)) && !(ascending ? Next() : Prev()))
+				return false;
+			positioned = true;
+		}
+		SetBoundary(end.bounded ? (Byte*)end.data : nullptr, end.size, end.inclusive, false);
+		if (Within())
+			return true;
+	}
+	return false;
+}
+
+// Interning takes a global lock, so it waits for the first operation timed on this cursor
+int NativeCursor::LatencyTable() {
+	if (latencyTable_ < 0 && IsLatencyTracking())
+		latencyTable_ = InternLatencyTable(cursor_->uri);
+	return latencyTable_;
 }
 
 bool NativeCursor::Search(Byte* key, int keyLength) {
 	SetKey(key, keyLength);
+	LatencyScope latency(LatencyTable(), NativeLatencySearch);
 	int r = cursor_->search(cursor_);
 	if (r == WT_NOTFOUND)
 		return false;
@@ -45,8 +131,67 @@ bool NativeCursor::Search(Byte* key, int keyLength) {
 	return true;
 }
 
+bool NativeCursor::Get(Byte* key, int keyLength, WT_ITEM* value) {
+	if (!Search(key, keyLength))
+		return false;
+	GetValue(value);
+	return true;
+}
+
+static void PackedOrder(const Byte* keys, const int* keyOffsets, int count, bool sort, std::vector<int>& order) {
+	order.resize(count);
+	for (int i = 0; i < count; i++)
+		order[i] = i;
+	if (sort)
+		std::stable_sort(order.begin(), order.end(), [keys, keyOffsets](int a, int b) {
+			return CompareBytes(keys + keyOffsets[a], keyOffsets[a + 1] - keyOffsets[a],
+				keys + keyOffsets[b], keyOffsets[b + 1] - keyOffsets[b]) < 0;
+		});
+}
+
+// how many rows MultiGet walks with next before falling back to search_near
+const int multiGetMaxSteps = 8;
+
+void NativeCursor::MultiGet(const Byte* keys, const int* keyOffsets, int count, std::vector<Byte>& values, int* valueOffsets, int* valueSizes) {
+	std::vector<int> order;
+	PackedOrder(keys, keyOffsets, count, true, order);
+	bool positioned = false;
+	for (int i = 0; i < count; i++) {
+		int index = order[i];
+		Byte* key = (Byte*)keys + keyOffsets[index];
+		int keySize = keyOffsets[index + 1] - keyOffsets[index];
+		int compareResult = -1;
+		if (positioned) {
+			compareResult = CompareKey(key, keySize);
+			for (int step = 0; compareResult < 0 && step < multiGetMaxSteps; step++) {
+				if (!Next()) {
+					positioned = false;
+					break;
+				}
+				compareResult = CompareKey(key, keySize);
+			}
+		}
+		if (!positioned || compareResult < 0) {
+			positioned = SearchNear(key, keySize, &compareResult);
+			if (!positioned)
+				compareResult = -1;
+		}
+		if (compareResult != 0) {
+			valueOffsets[index] = -1;
+			valueSizes[index] = 0;
+			continue;
+		}
+		WT_ITEM value = { 0 };
+		GetValue(&value);
+		valueOffsets[index] = (int)values.size();
+		valueSizes[index] = (int)value.size;
+		values.insert(values.end(), (const Byte*)value.data, (const Byte*)value.data + value.size);
+	}
+}
+
 bool NativeCursor::SearchNear(Byte* data, int length, int* exact) {
 	SetKey(data, length);
+	LatencyScope latency(LatencyTable(), NativeLatencySearchNear);
 	int r = cursor_->search_near(cursor_, exact);
 	if (r == WT_NOTFOUND)
 		return false;
@@ -56,6 +201,7 @@ bool NativeCursor::SearchNear(Byte* data, int length, int* exact) {
 }
 
 bool NativeCursor::Next() {
+	LatencyScope latency(LatencyTable(), NativeLatencyNext);
 	int r = cursor_->next(cursor_);
 	if (r == WT_NOTFOUND)
 		return false;
@@ -65,6 +211,7 @@ bool NativeCursor::Next() {
 }
 
 bool NativeCursor::Prev() {
+	LatencyScope latency(LatencyTable(), NativeLatencyPrev);
 	int r = cursor_->prev(cursor_);
 	if (r == WT_NOTFOUND)
 		return false;
@@ -73,20 +220,25 @@ bool NativeCursor::Prev() {
 	return true;
 }
 
+int NativeCursor::CompareKey(const Byte* data, int size) {
+	WT_ITEM item = { 0 };
+	GetKey(&item);
+	return CompareBytes((const Byte*)item.data, (int)item.size, data, size);
+}
+
 bool NativeCursor::Within() {
 	if (boundary_ == nullptr)
 		return true;
-	WT_ITEM item = { 0 };
-	GetKey(&item);
-	int result = memcmp(item.data, boundary_, min((int)item.size, boundarySize_));
-	if (result == 0 && item.size != boundarySize_)
-		result = item.size < boundarySize_ ? -1 : 1;
+	int result = CompareKey(boundary_, boundarySize_);
 	if (result == 0)
 		return boundaryInclusive_;
 	return direction_ == Ascending ? result < 0 : result > 0;
 }
 
 void NativeCursor::SetBoundary(Byte* boundary, int boundarySize, bool boundaryInclusive, bool copyBoundary) {
+	if (boundary_ != nullptr && ownsBoundary_)
+		delete[] boundary_;
+	boundary_ = nullptr;
 	if (boundary == nullptr)
 		return;
 	boundarySize_ = boundarySize;
@@ -107,6 +259,9 @@ int NativeCursor::Reset() {
 	if (ownsBoundary_)
 		delete[] boundary_;
 	boundary_ = nullptr;
+	hasCurrent_ = false;
+	ranges_.Clear();
+	nextRange_ = 0;
 	return 0;
 }
 
@@ -134,9 +289,132 @@ __int64 NativeCursor::GetTotalCount(Byte* left, int leftSize, bool leftInclusive
 	return result;
 }
 
+__int64 NativeCursor::GetTotalCount(const NativeRangeSet& ranges, __int64 maxCount) {
+	__int64 result = 0;
+	if (maxCount <= 0)
+		return 0;
+	if (IterationBegin(ranges, Ascending))
+		do
+		{
+			result++;
+		} while ((result < maxCount) && IterationMove());
+	return result;
+}
+
+static NativeCountEstimate ExactCount(__int64 count) {
+	NativeCountEstimate result = { count, count, count, true };
+	return result;
+}
+
+// z of the 95% confidence interval
+const double estimateZ = 1.96;
+const int estimateBatch = 256;
+
+NativeCountEstimate NativeCursor::EstimateCount(Byte* left, int leftSize, bool leftInclusive, Byte* right, int rightSize, bool rightInclusive,
+	double errorBudget, __int64 totalCount) {
+	if (errorBudget <= 0 || errorBudget >= 1)
+		throw NativeWiredTigerApiException(EINVAL, "EstimateCount, errorBudget must be in (0, 1)");
+	// enough samples for errorBudget when the range holds at least 1/16 of the table
+	double samples = ceil(16 * estimateZ * estimateZ / (errorBudget * errorBudget));
+	__int64 maxSamples = (__int64)std::min(std::max(samples, 1024.0), 1048576.0);
+	// walking keys in order is much cheaper than random descents, so ranges up to exactLimit are counted
+	__int64 exactLimit = 8 * maxSamples;
+	if (totalCount < 0) {
+		const int key = WT_STAT_DSRC_BTREE_ENTRIES;
+		try {
+			ReadStatistics(cursor_->session, cursor_->uri, nullptr, &key, 1, &totalCount);
+		}
+		catch (const NativeWiredTigerApiException&) {
+			totalCount = 0;
+		}
+		// entries are zero when the database does not collect tree walk statistics
+		if (totalCount <= 0)
+			totalCount = -1;
+	}
+	__int64 limit = totalCount < 0 || totalCount <= exactLimit ? LLONG_MAX : exactLimit;
+	__int64 counted = GetTotalCount(left, leftSize, leftInclusive, right, rightSize, rightInclusive, limit);
+	Reset();
+	if (counted < limit)
+		return ExactCount(counted);
+
+	std::string config = "next_random=true,next_random_sample_size=" + std::to_string(maxSamples);
+	std::unique_ptr<NativeCursor> random(OpenNativeCursor(cursor_->session, cursor_->uri, config.c_str()));
+	__int64 hits = 0;
+	__int64 taken = 0;
+	NativeCountEstimate result = { counted, counted, totalCount, false };
+	while (taken < maxSamples) {
+		for (int i = 0; i < estimateBatch; i++) {
+			if (!random->Next())
+				throw NativeWiredTigerApiException(WT_NOTFOUND, "EstimateCount, next_random cursor->next");
+			if (random->Contains(left, leftSize, leftInclusive, right, rightSize, rightInclusive))
+				hits++;
+		}
+		taken += estimateBatch;
+		// Wilson score interval of the share of the table in the range
+		double n = (double)taken;
+		double share = hits / n;
+		double z2 = estimateZ * estimateZ;
+		double center = (share + z2 / (2 * n)) / (1 + z2 / n);
+		double half = estimateZ * sqrt(share * (1 - share) / n + z2 / (4 * n * n)) / (1 + z2 / n);
+		// the exact walk has already seen counted keys, the table may have grown since the statistics were read
+		result.lower = std::max(counted, (__int64)((center - half) * totalCount));
+		result.upper = std::max(result.lower, (__int64)ceil((center + half) * totalCount));
+		result.estimate = std::min(std::max((__int64)(share * totalCount + 0.5), result.lower), result.upper);
+		if (result.upper - result.lower <= 2 * errorBudget * result.estimate)
+			break;
+	}
+	return result;
+}
+
+bool NativeCursor::Contains(const Byte* left, int leftSize, bool leftInclusive, const Byte* right, int rightSize, bool rightInclusive) {
+	if (left != nullptr) {
+		int result = CompareKey(left, leftSize);
+		if (result < 0 || result == 0 && !leftInclusive)
+			return false;
+	}
+	if (right != nullptr) {
+		int result = CompareKey(right, rightSize);
+		if (result > 0 || result == 0 && !rightInclusive)
+			return false;
+	}
+	return true;
+}
+
 bool NativeCursor::IterationMove() {
 	bool moved = direction_ == Ascending ? Next() : Prev();
-	return moved && Within();
+	hasCurrent_ = moved && Within();
+	if (!hasCurrent_ && moved && nextRange_ < ranges_.Count())
+		hasCurrent_ = EnterRange(true);
+	return hasCurrent_;
+}
+
+int NativeCursor::FetchBatch(Byte* buffer, int bufferSize, int* offsets, int maxRows, int* requiredSize) {
+	int rows = 0;
+	int used = 0;
+	*requiredSize = 0;
+	offsets[0] = 0;
+	while (rows < maxRows && hasCurrent_) {
+		WT_ITEM key = { 0 };
+		WT_ITEM value = { 0 };
+		GetKey(&key);
+		if (hasValue_)
+			GetValue(&value);
+		int rowSize = (int)(key.size + value.size);
+		if (rowSize > bufferSize - used) {
+			if (rows == 0)
+				*requiredSize = rowSize;
+			break;
+		}
+		memcpy(buffer + used, key.data, key.size);
+		used += (int)key.size;
+		offsets[2 * rows + 1] = used;
+		memcpy(buffer + used, value.data, value.size);
+		used += (int)value.size;
+		offsets[2 * rows + 2] = used;
+		rows++;
+		IterationMove();
+	}
+	return rows;
 }
 
 void NativeCursor::GetKey(WT_ITEM* target) {
@@ -161,29 +439,149 @@ void NativeCursor::GetValue(WT_ITEM* target) {
 		throw NativeWiredTigerApiException(r, "cursor->get_value");
 }
 
+static int CopyItem(const WT_ITEM& item, Byte* buffer, int bufferSize) {
+	if ((int)item.size <= bufferSize)
+		memcpy(buffer, item.data, item.size);
+	return (int)item.size;
+}
+
+int NativeCursor::GetKey(Byte* buffer, int bufferSize) {
+	WT_ITEM item = { 0 };
+	GetKey(&item);
+	return CopyItem(item, buffer, bufferSize);
+}
+
+int NativeCursor::GetValue(Byte* buffer, int bufferSize) {
+	WT_ITEM item = { 0 };
+	GetValue(&item);
+	return CopyItem(item, buffer, bufferSize);
+}
+
+NativeBytes NativeCursor::KeyView() {
+	WT_ITEM item = { 0 };
+	GetKey(&item);
+	NativeBytes result = { (const Byte*)item.data, (int)item.size };
+	return result;
+}
+
+NativeBytes NativeCursor::ValueView() {
+	WT_ITEM item = { 0 };
+	GetValue(&item);
+	NativeBytes result = { (const Byte*)item.data, (int)item.size };
+	return result;
+}
+
 void NativeCursor::Remove(Byte* key, int keyLength) {
-	SetKey(key, keyLength);
-	int r = cursor_->remove(cursor_);
+	int r = TryRemove(key, keyLength);
 	if (r != 0)
 		throw NativeWiredTigerApiException(r, "cursor->remove");
 }
 
-void NativeCursor::Insert(Byte* key, int keyLength, Byte* value, int valueLength) {
+int NativeCursor::TryRemove(Byte* key, int keyLength) {
 	SetKey(key, keyLength);
-	SetValue(value, valueLength);
-	int r = cursor_->insert(cursor_);
+	LatencyScope latency(LatencyTable(), NativeLatencyRemove);
+	return cursor_->remove(cursor_);
+}
+
+template<typename TApply>
+static int ApplyBatch(const std::vector<int>& order, int* statuses, const char* apiName, TApply apply) {
+	int failed = 0;
+	int count = (int)order.size();
+	for (int i = 0; i < count; i++) {
+		int r = apply(order[i]);
+		if (r == 0) {
+			if (statuses != nullptr)
+				statuses[order[i]] = 0;
+			continue;
+		}
+		if (statuses == nullptr)
+			throw NativeWiredTigerApiException(r, apiName);
+		failed++;
+		statuses[order[i]] = r;
+		if (r == WT_ROLLBACK) {
+			for (int j = i + 1; j < count; j++)
+				statuses[order[j]] = WT_ROLLBACK;
+			return failed + count - i - 1;
+		}
+	}
+	return failed;
+}
+
+int NativeCursor::InsertBatch(const Byte* keys, const int* keyOffsets, const Byte* values, const int* valueOffsets, int count, bool sort, int* statuses) {
+	std::vector<int> order;
+	PackedOrder(keys, keyOffsets, count, sort, order);
+	return ApplyBatch(order, statuses, "cursor->insert", [this, keys, keyOffsets, values, valueOffsets](int i) {
+		SetKey((Byte*)keys + keyOffsets[i], keyOffsets[i + 1] - keyOffsets[i]);
+		if (values != nullptr)
+			SetValue((Byte*)values + valueOffsets[i], valueOffsets[i + 1] - valueOffsets[i]);
+		else
+			cursor_->set_value(cursor_);
+		LatencyScope latency(LatencyTable(), NativeLatencyInsert);
+		return cursor_->insert(cursor_);
+	});
+}
+
+int NativeCursor::RemoveBatch(const Byte* keys, const int* keyOffsets, int count, bool sort, int* statuses) {
+	std::vector<int> order;
+	PackedOrder(keys, keyOffsets, count, sort, order);
+	return ApplyBatch(order, statuses, "cursor->remove", [this, keys, keyOffsets](int i) {
+		SetKey((Byte*)keys + keyOffsets[i], keyOffsets[i + 1] - keyOffsets[i]);
+		LatencyScope latency(LatencyTable(), NativeLatencyRemove);
+		return cursor_->remove(cursor_);
+	});
+}
+
+bool NativeCursor::Modify(Byte* key, int keyLength, WT_MODIFY* entries, int count) {
+	int r = TryModify(key, keyLength, entries, count);
+	if (r == WT_NOTFOUND)
+		return false;
+	if (r != 0)
+		throw NativeWiredTigerApiException(r, "cursor->modify");
+	return true;
+}
+
+int NativeCursor::ModifyBatch(const Byte* keys, const int* keyOffsets, const int* entryOffsets, WT_MODIFY* entries, int count, bool sort, int* statuses) {
+	std::vector<int> order;
+	PackedOrder(keys, keyOffsets, count, sort, order);
+	return ApplyBatch(order, statuses, "cursor->modify", [this, keys, keyOffsets, entryOffsets, entries](int i) {
+		SetKey((Byte*)keys + keyOffsets[i], keyOffsets[i + 1] - keyOffsets[i]);
+		LatencyScope latency(LatencyTable(), NativeLatencyModify);
+		return cursor_->modify(cursor_, entries + entryOffsets[i], entryOffsets[i + 1] - entryOffsets[i]);
+	});
+}
+
+int NativeCursor::TryModify(Byte* key, int keyLength, WT_MODIFY* entries, int count) {
+	SetKey(key, keyLength);
+	LatencyScope latency(LatencyTable(), NativeLatencyModify);
+	return cursor_->modify(cursor_, entries, count);
+}
+
+void NativeCursor::Insert(Byte* key, int keyLength, Byte* value, int valueLength) {
+	int r = TryInsert(key, keyLength, value, valueLength);
 	if (r != 0)
 		throw NativeWiredTigerApiException(r, "cursor->insert");
 }
 
 void NativeCursor::Insert(Byte* key, int keyLength) {
-	SetKey(key, keyLength);
-	cursor_->set_value(cursor_);
-	int r = cursor_->insert(cursor_);
+	int r = TryInsert(key, keyLength);
 	if (r != 0)
 		throw NativeWiredTigerApiException(r, "cursor->insert");
 }
 
+int NativeCursor::TryInsert(Byte* key, int keyLength, Byte* value, int valueLength) {
+	SetKey(key, keyLength);
+	SetValue(value, valueLength);
+	LatencyScope latency(LatencyTable(), NativeLatencyInsert);
+	return cursor_->insert(cursor_);
+}
+
+int NativeCursor::TryInsert(Byte* key, int keyLength) {
+	SetKey(key, keyLength);
+	cursor_->set_value(cursor_);
+	LatencyScope latency(LatencyTable(), NativeLatencyInsert);
+	return cursor_->insert(cursor_);
+}
+
 void NativeCursor::SetKey(Byte* data, int length) {
 	if (keyIsString_) {
 		const char* s = (const char *)data;
@@ -215,4 +613,147 @@ NativeCursor* OpenNativeCursor(WT_SESSION* session, const char* name, const char
 		throw NativeWiredTigerApiException(r, fullApiName);
 	}
 	return new NativeCursor(cursor);
-}
\ No newline at end of file
+}
+
+NativeCursorCache::NativeCursorCache(WT_SESSION* session, int maxPerKey) : session_(session), maxPerKey_(maxPerKey) {
+}
+
+NativeCursorCache::~NativeCursorCache() {
+	Clear();
+}
+
+NativeCursor* NativeCursorCache::Acquire(const char* name, const char* config) {
+	std::string key(name);
+	key.push_back('\0');
+	if (config != nullptr)
+		key.append(config);
+	std::map<std::string, std::vector<NativeCursor*>>::iterator it = cursors_.find(key);
+	if (it != cursors_.end() && !it->second.empty()) {
+		NativeCursor* result = it->second.back();
+		it->second.pop_back();
+		return result;
+	}
+	NativeCursor* result = OpenNativeCursor(session_, name, config);
+	result->cacheKey_.swap(key);
+	return result;
+}
+
+void NativeCursorCache::Release(NativeCursor* cursor) {
+	std::vector<NativeCursor*>& cached = cursors_[cursor->cacheKey_];
+	if ((int)cached.size() >= maxPerKey_ || cursor->Reset() != 0) {
+		delete cursor;
+		return;
+	}
+	cached.push_back(cursor);
+}
+
+void NativeCursorCache::Clear() {
+	for (std::map<std::string, std::vector<NativeCursor*>>::iterator it = cursors_.begin(); it != cursors_.end(); ++it)
+		for (size_t i = 0; i < it->second.size(); i++)
+			delete it->second[i];
+	cursors_.clear();
+}
+
+void TruncateRange(WT_SESSION* session, const char* name, Byte* left, int leftSize, bool leftInclusive, Byte* right, int rightSize, bool rightInclusive) {
+	const char* truncateName = name;
+	std::unique_ptr<NativeCursor> start;
+	std::unique_ptr<NativeCursor> stop;
+	// truncate bounds are inclusive, so position cursors on the first and the last keys of the range
+	if (left != nullptr) {
+		start.reset(OpenNativeCursor(session, name, nullptr));
+		if (!start->IterationBegin(left, leftSize, leftInclusive, right, rightSize, rightInclusive, Ascending, false))
+			return;
+		truncateName = nullptr;
+	}
+	if (right != nullptr) {
+		stop.reset(OpenNativeCursor(session, name, nullptr));
+		if (!stop->IterationBegin(left, leftSize, leftInclusive, right, rightSize, rightInclusive, Descending, false))
+			return;
+		truncateName = nullptr;
+	}
+	int r = session->truncate(session, truncateName,
+		start ? start->cursor_ : nullptr, stop ? stop->cursor_ : nullptr, nullptr);
+	if (r != 0) {
+		std::string fullApiName = "session->truncate";
+		fullApiName.append(", ");
+		fullApiName.append(name);
+		throw NativeWiredTigerApiException(r, fullApiName);
+	}
+}
+
+static const int retryBackoffBaseMicroseconds = 16;
+static const int retryBackoffMaxMicroseconds = 16000;
+
+static void Backoff(std::minstd_rand& random, int attempt) {
+	int limit = retryBackoffBaseMicroseconds << min(attempt, 20);
+	if (limit > retryBackoffMaxMicroseconds)
+		limit = retryBackoffMaxMicroseconds;
+	// full jitter, so conflicting writers spread out instead of colliding again
+	std::chrono::microseconds delay((int)(random() % (unsigned int)(limit + 1)));
+	// sleep granularity is about a millisecond on Windows. Only the first retry waits less by yielding,
+	// later ones sleep that long plus the jitter rather than burn a core while the conflicting writer finishes.
+	if (attempt == 0 && delay < std::chrono::milliseconds(1)) {
+		std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + delay;
+		while (std::chrono::steady_clock::now() < deadline)
+			std::this_thread::yield();
+		return;
+	}
+	if (attempt > 0)
+		delay += std::chrono::milliseconds(1);
+	std::this_thread::sleep_for(delay);
+}
+
+int RunTransaction(WT_SESSION* session, const char* beginConfig, const char* commitConfig,
+	NativeTransactionBody body, void* context, int maxAttempts, int* attempts) {
+	std::minstd_rand random((unsigned int)std::chrono::steady_clock::now().time_since_epoch().count() ^
+		(unsigned int)(size_t)session);
+	int r = 0;
+	int attempt = 0;
+	while (attempt < maxAttempts) {
+		if (attempt > 0)
+			Backoff(random, attempt - 1);
+		attempt++;
+		r = session->begin_transaction(session, beginConfig);
+		if (r != 0)
+			break;
+		r = body(context);
+		if (r != 0)
+			session->rollback_transaction(session, nullptr);
+		else
+			// WiredTiger rolls the transaction back when commit fails with any error, WT_ROLLBACK or not,
+			// so no transaction is left open on the session whatever r is
+			r = session->commit_transaction(session, commitConfig);
+		if (r != WT_ROLLBACK)
+			break;
+	}
+	if (attempts != nullptr)
+		*attempts = attempt;
+	return r;
+}
+
+void ReadStatistics(WT_SESSION* session, const char* uri, const char* config, const int* keys, int count, __int64* values) {
+	std::string statisticsUri("statistics:");
+	statisticsUri.append(uri);
+	WT_CURSOR* cursor;
+	int r = session->open_cursor(session, statisticsUri.c_str(), nullptr, config, &cursor);
+	if (r != 0)
+		throw NativeWiredTigerApiException(r, "session->open_cursor, " + statisticsUri);
+	for (int i = 0; i < count && r == 0; i++) {
+		cursor->set_key(cursor, keys[i]);
+		r = cursor->search(cursor);
+		if (r == 0) {
+			const char* description;
+			const char* printable;
+			int64_t value;
+			r = cursor->get_value(cursor, &description, &printable, &value);
+			values[i] = value;
+		}
+		else if (r == WT_NOTFOUND) {
+			values[i] = 0;
+			r = 0;
+		}
+	}
+	cursor->close(cursor);
+	if (r != 0)
+		throw NativeWiredTigerApiException(r, "statistics cursor->search, " + statisticsUri);
+}
@@ -1,7 +1,9 @@
+#pragma once
 #include <wiredtiger.h>
 #include <string>
-
-typedef unsigned char Byte;
+#include <vector>
+#include <map>
+#include "NativeRanges.h"
 
 class NativeWiredTigerApiException : public std::exception {
 public:
@@ -15,6 +17,19 @@ private:
 	const std::string apiName_;
 };
 
+struct NativeBytes {
+	const Byte* data;
+	int size;
+};
+
+// Count of a range with a confidence interval, lower <= estimate <= upper. Exact counts have equal bounds.
+struct NativeCountEstimate {
+	__int64 estimate;
+	__int64 lower;
+	__int64 upper;
+	bool exact;
+};
+
 enum NativeDirection {
 	Ascending,
 	Descending
@@ -24,35 +39,123 @@ class NativeCursor {
 public:
 	~NativeCursor();
 	bool IterationBegin(Byte* left, int leftSize, bool leftInclusive, Byte* right, int rightSize, bool rightInclusive, NativeDirection newDirection, bool copyBoundary);
+	// Iterates the union of ranges in one pass. When the cursor leaves a range it continues from its position
+	// while that lies within or beyond the following ranges, and seeks with search_near only across gaps.
+	bool IterationBegin(const std::vector<NativeRange>& ranges, NativeDirection newDirection);
+	bool IterationBegin(const NativeRangeSet& ranges, NativeDirection newDirection);
 	bool IterationMove();
+	// Packs rows of the iteration started by IterationBegin into buffer, beginning with the current row:
+	// key i occupies [offsets[2 * i], offsets[2 * i + 1]) and value i occupies [offsets[2 * i + 1], offsets[2 * i + 2]),
+	// so offsets must have room for 2 * maxRows + 1 entries. Returns the number of packed rows, the cursor is left
+	// on the first row not packed, so the next call resumes from it. When even the first row does not fit,
+	// returns 0 and sets requiredSize to the buffer size it needs.
+	int FetchBatch(Byte* buffer, int bufferSize, int* offsets, int maxRows, int* requiredSize);
 	__int64 GetTotalCount(Byte* left, int leftSize, bool leftInclusive, Byte* right, int rightSize, bool rightInclusive, __int64 maxCount);
+	__int64 GetTotalCount(const NativeRangeSet& ranges, __int64 maxCount);
+	// Estimates the count of the range within relative errorBudget at 95% confidence by sampling keys of the table with
+	// a next_random cursor, scaled by totalCount or, when it is negative, by the entries statistic of the table.
+	// Ranges too small to sample well and tables without statistics are counted exactly. Leaves the cursor reset.
+	NativeCountEstimate EstimateCount(Byte* left, int leftSize, bool leftInclusive, Byte* right, int rightSize, bool rightInclusive,
+		double errorBudget, __int64 totalCount);
 	int Reset();
 	const char* KeyFormat() const { return cursor_->key_format; }
 	const char* ValueFormat() const { return cursor_->value_format; }
 	bool Search(Byte* key, int keyLength);
+	// Search and fetch the value in one call, value stays valid until the next operation on this cursor
+	bool Get(Byte* key, int keyLength, WT_ITEM* value);
+	// Resolves count keys packed as keys[keyOffsets[i], keyOffsets[i + 1]) in sorted order, appending found values
+	// to values; valueOffsets[i] is set to the value position in values or to -1 when key i is not found
+	void MultiGet(const Byte* keys, const int* keyOffsets, int count, std::vector<Byte>& values, int* valueOffsets, int* valueSizes);
 	bool SearchNear(Byte* data, int length, int* exact);
 	bool Next();
 	bool Prev();
 	void Insert(Byte* key, int keyLength, Byte* value, int valueLength);
 	void Insert(Byte* key, int keyLength);
 	void Remove(Byte* key, int keyLength);
+	// Try variants return the WiredTiger error code instead of throwing
+	int TryInsert(Byte* key, int keyLength, Byte* value, int valueLength);
+	int TryInsert(Byte* key, int keyLength);
+	int TryRemove(Byte* key, int keyLength);
+	// Apply count items packed as keys[keyOffsets[i], keyOffsets[i + 1]) and values[valueOffsets[i], valueOffsets[i + 1]),
+	// values is nullptr for key only schema. When sort is set items are applied in key order. With statuses every item
+	// gets its return code and the batch stops only on WT_ROLLBACK, without statuses the first failure throws.
+	// Returns the number of failed items.
+	int InsertBatch(const Byte* keys, const int* keyOffsets, const Byte* values, const int* valueOffsets, int count, bool sort, int* statuses);
+	int RemoveBatch(const Byte* keys, const int* keyOffsets, int count, bool sort, int* statuses);
+	// Applies entries to the existing value of key, returns false when key is not found.
+	// Modify is meant for snapshot isolation, see WT_CURSOR::modify
+	bool Modify(Byte* key, int keyLength, WT_MODIFY* entries, int count);
+	int TryModify(Byte* key, int keyLength, WT_MODIFY* entries, int count);
+	// Key i gets entries[entryOffsets[i], entryOffsets[i + 1]), statuses work as in InsertBatch
+	int ModifyBatch(const Byte* keys, const int* keyOffsets, const int* entryOffsets, WT_MODIFY* entries, int count, bool sort, int* statuses);
 	void GetKey(WT_ITEM* target);
 	void GetValue(WT_ITEM* target);
+	// Copy into buffer only when it is large enough, return the required size in any case
+	int GetKey(Byte* buffer, int bufferSize);
+	int GetValue(Byte* buffer, int bufferSize);
+	// Views point into WiredTiger-owned memory and stay valid only until the next operation on this cursor
+	NativeBytes KeyView();
+	NativeBytes ValueView();
+	// Whether the current key lies within the range, null boundaries mean unbounded sides
+	bool Contains(const Byte* left, int leftSize, bool leftInclusive, const Byte* right, int rightSize, bool rightInclusive);
 
 	friend NativeCursor* OpenNativeCursor(WT_SESSION* session, const char* name, const char* config);
+	friend class NativeCursorCache;
+	friend void TruncateRange(WT_SESSION* session, const char* name, Byte* left, int leftSize, bool leftInclusive, Byte* right, int rightSize, bool rightInclusive);
 private:
 	NativeCursor(WT_CURSOR* cursor);
 	WT_CURSOR* cursor_;
 	bool keyIsString_;
+	bool hasValue_;
+	bool hasCurrent_;
 	NativeDirection direction_;
 	Byte* boundary_;
 	int boundarySize_;
 	bool boundaryInclusive_;
 	bool ownsBoundary_;
+	std::string cacheKey_;
+	// -1 until the first operation timed while latency tracking is on
+	int latencyTable_;
+	// ranges of a multi-range iteration and how many of them were entered, in iteration order
+	NativeRangeSet ranges_;
+	int nextRange_;
 	bool Within();
+	int LatencyTable();
+	bool EnterRange(bool positioned);
+	int CompareKey(const Byte* data, int size);
 	void SetKey(Byte* data, int length);
 	void SetValue(Byte* data, int length);
 	void SetBoundary(Byte* boundary, int boundarySize, bool boundaryInclusive, bool ownsBoundary);
 };
 
-NativeCursor* OpenNativeCursor(WT_SESSION* session, const char* name, const char* config);
\ No newline at end of file
+NativeCursor* OpenNativeCursor(WT_SESSION* session, const char* name, const char* config);
+// Keeps cursors returned by users open and reset, handing them out again for the same name and config.
+// Like the session it belongs to, the cache is single threaded.
+class NativeCursorCache {
+public:
+	NativeCursorCache(WT_SESSION* session, int maxPerKey);
+	~NativeCursorCache();
+	NativeCursor* Acquire(const char* name, const char* config);
+	void Release(NativeCursor* cursor);
+	void Clear();
+private:
+	NativeCursorCache(const NativeCursorCache&);
+	NativeCursorCache& operator=(const NativeCursorCache&);
+	WT_SESSION* session_;
+	int maxPerKey_;
+	std::map<std::string, std::vector<NativeCursor*>> cursors_;
+};
+
+// Removes keys of the range with WT_SESSION::truncate, null boundaries mean unbounded sides
+void TruncateRange(WT_SESSION* session, const char* name, Byte* left, int leftSize, bool leftInclusive, Byte* right, int rightSize, bool rightInclusive);
+typedef int(*NativeTransactionBody)(void* context);
+
+// Runs body in a transaction and commits it, retrying with jittered exponential backoff while body or
+// commit fail with WT_ROLLBACK, at most maxAttempts times. Any other failure of body rolls back and stops.
+// Returns the error code of the last attempt, attempts receives the number of attempts made.
+int RunTransaction(WT_SESSION* session, const char* beginConfig, const char* commitConfig,
+	NativeTransactionBody body, void* context, int maxAttempts, int* attempts);
+
+// Reads count statistics of a statistics cursor opened on "statistics:" + uri, values[i] receives statistic keys[i]
+// or 0 when the cursor does not report it
+void ReadStatistics(WT_SESSION* session, const char* uri, const char* config, const int* keys, int count, __int64* values);
@@ -0,0 +1,326 @@
+#include "NativeWriteBatcher.h"
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace {
+	struct WriteOp {
+		std::atomic<WriteOp*> next;
+		NativeWriteOpType type;
+		__int64 token;
+		int result;
+		std::string uri;
+		std::vector<Byte> data;
+		int keySize;
+	};
+
+	// Intrusive multi-producer single-consumer queue: a push is one exchange and one store.
+	// Pop may miss a push that is in progress, the producer wakes the consumer after it finishes.
+	class WriteQueue {
+	public:
+		WriteQueue() : head_(&stub_), tail_(&stub_) {
+			stub_.next = nullptr;
+		}
+		void Push(WriteOp* op) {
+			op->next.store(nullptr, std::memory_order_relaxed);
+			WriteOp* previous = head_.exchange(op, std::memory_order_acq_rel);
+			previous->next.store(op, std::memory_order_release);
+		}
+		WriteOp* Pop() {
+			WriteOp* tail = tail_;
+			WriteOp* next = tail->next.load(std::memory_order_acquire);
+			if (tail == &stub_) {
+				if (next == nullptr)
+					return nullptr;
+				tail_ = next;
+				tail = next;
+				next = next->next.load(std::memory_order_acquire);
+			}
+			if (next != nullptr) {
+				tail_ = next;
+				return tail;
+			}
+			if (tail != head_.load(std::memory_order_acquire))
+				return nullptr;
+			Push(&stub_);
+			next = tail->next.load(std::memory_order_acquire);
+			if (next != nullptr) {
+				tail_ = next;
+				return tail;
+			}
+			return nullptr;
+		}
+	private:
+		WriteQueue(const WriteQueue&);
+		WriteQueue& operator=(const WriteQueue&);
+		std::atomic<WriteOp*> head_;
+		WriteOp* tail_;
+		WriteOp stub_;
+	};
+
+	// Attempts of a transaction that was rolled back because of a conflict
+	const int writeConflictRetries = 3;
+
+	bool IsBenign(int r) {
+		// these leave the transaction usable, see API_END_RET in WiredTiger
+		return r == 0 || r == WT_NOTFOUND || r == WT_DUPLICATE_KEY;
+	}
+
+	unsigned int HashKey(const Byte* key, int keySize) {
+		unsigned int hash = 2166136261u;
+		for (int i = 0; i < keySize; i++) {
+			hash ^= key[i];
+			hash *= 16777619u;
+		}
+		return hash;
+	}
+
+	struct Writer {
+		WT_SESSION* session;
+		// by op type, removes use overwrite=false cursors to report missing keys
+		std::map<std::string, WT_CURSOR*> cursors[2];
+		WriteQueue queue;
+		std::atomic<bool> sleeping;
+		std::mutex mutex;
+		std::condition_variable wake;
+		std::thread thread;
+
+		void Wake() {
+			// pairs with the fence in Sleep: either the producer sees sleeping or the writer sees the write
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (sleeping.load()) {
+				std::lock_guard<std::mutex> lock(mutex);
+				sleeping = false;
+				wake.notify_one();
+			}
+		}
+	};
+}
+
+struct NativeWriteBatcher::State {
+	WT_CONNECTION* connection;
+	std::vector<Writer*> writers;
+	size_t maxBatch;
+	std::chrono::microseconds maxDelay;
+	std::string commitConfig;
+	NativeCompletionQueue* queue;
+	std::atomic<bool> stopping;
+	std::atomic<__int64> writes;
+	std::atomic<__int64> transactions;
+
+	// Pops writes into batch until it is full or the queue is empty
+	void Drain(Writer* writer, std::vector<WriteOp*>& batch) {
+		while (batch.size() < maxBatch) {
+			WriteOp* op = writer->queue.Pop();
+			if (op == nullptr)
+				break;
+			batch.push_back(op);
+		}
+	}
+
+	// Blocks until a producer wakes the writer, the batcher stops or deadline passes, without deadline
+	// there is no timeout. A write that arrived before the writer went to sleep is added to batch instead.
+	void Sleep(Writer* writer, std::vector<WriteOp*>& batch, const std::chrono::steady_clock::time_point* deadline) {
+		std::unique_lock<std::mutex> lock(writer->mutex);
+		writer->sleeping = true;
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		WriteOp* op = writer->queue.Pop();
+		if (op != nullptr)
+			batch.push_back(op);
+		else if (deadline == nullptr)
+			writer->wake.wait(lock, [this, writer] { return !writer->sleeping || stopping; });
+		else
+			writer->wake.wait_until(lock, *deadline, [this, writer] { return !writer->sleeping || stopping; });
+		writer->sleeping = false;
+	}
+
+	// Fills batch, waits for the first write and up to maxDelay for more.
+	// Returns false when stopping and nothing is left.
+	bool Collect(Writer* writer, std::vector<WriteOp*>& batch) {
+		while (true) {
+			Drain(writer, batch);
+			if (!batch.empty())
+				break;
+			if (stopping)
+				return false;
+			Sleep(writer, batch, nullptr);
+		}
+		if (maxDelay.count() > 0) {
+			std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + maxDelay;
+			while (true) {
+				Drain(writer, batch);
+				if (batch.size() >= maxBatch || stopping || std::chrono::steady_clock::now() >= deadline)
+					break;
+				Sleep(writer, batch, &deadline);
+			}
+		}
+		return true;
+	}
+
+	int Apply(Writer* writer, WriteOp* op) {
+		WT_CURSOR* cursor;
+		std::map<std::string, WT_CURSOR*>& cursors = writer->cursors[op->type];
+		std::map<std::string, WT_CURSOR*>::iterator it = cursors.find(op->uri);
+		if (it != cursors.end())
+			cursor = it->second;
+		else {
+			const char* config = op->type == NativeWriteRemove ? "overwrite=false" : nullptr;
+			int r = writer->session->open_cursor(writer->session, op->uri.c_str(), nullptr, config, &cursor);
+			if (r != 0)
+				return r;
+			// writes carry raw bytes, so keys and values must be WT_ITEMs
+			if (strcmp(cursor->key_format, "u") != 0 || strcmp(cursor->value_format, "u") != 0 && strcmp(cursor->value_format, "") != 0) {
+				cursor->close(cursor);
+				return EINVAL;
+			}
+			cursors[op->uri] = cursor;
+		}
+		WT_ITEM key = { 0 };
+		key.data = op->data.data();
+		key.size = op->keySize;
+		cursor->set_key(cursor, &key);
+		if (op->type == NativeWriteRemove)
+			return cursor->remove(cursor);
+		if (strcmp(cursor->value_format, "") != 0) {
+			WT_ITEM value = { 0 };
+			value.data = op->data.data() + op->keySize;
+			value.size = op->data.size() - op->keySize;
+			cursor->set_value(cursor, &value);
+		}
+		return cursor->insert(cursor);
+	}
+
+	int Commit(Writer* writer, WriteOp** ops, size_t count) {
+		WT_SESSION* session = writer->session;
+		int r = session->begin_transaction(session, nullptr);
+		if (r != 0)
+			return r;
+		for (size_t i = 0; i < count; i++) {
+			r = Apply(writer, ops[i]);
+			ops[i]->result = r;
+			if (!IsBenign(r)) {
+				session->rollback_transaction(session, nullptr);
+				return r;
+			}
+		}
+		return session->commit_transaction(session, commitConfig.empty() ? nullptr : commitConfig.c_str());
+	}
+
+	int CommitWithRetries(Writer* writer, WriteOp** ops, size_t count) {
+		int r = 0;
+		for (int attempt = 0; attempt < writeConflictRetries; attempt++) {
+			r = Commit(writer, ops, count);
+			if (r != WT_ROLLBACK)
+				break;
+		}
+		return r;
+	}
+
+	void Process(Writer* writer, std::vector<WriteOp*>& batch) {
+		int r = CommitWithRetries(writer, batch.data(), batch.size());
+		if (r == 0)
+			transactions++;
+		else if (batch.size() > 1) {
+			// one failing write must not fail the others, find it by committing writes one by one
+			for (size_t i = 0; i < batch.size(); i++) {
+				r = CommitWithRetries(writer, &batch[i], 1);
+				if (r == 0)
+					transactions++;
+				else
+					batch[i]->result = r;
+			}
+		}
+		else
+			batch[0]->result = r;
+		writes += batch.size();
+		for (size_t i = 0; i < batch.size(); i++) {
+			queue->Push(batch[i]->token, batch[i]->result, nullptr, 0);
+			delete batch[i];
+		}
+		batch.clear();
+	}
+
+	void Run(Writer* writer) {
+		std::vector<WriteOp*> batch;
+		batch.reserve(maxBatch);
+		while (Collect(writer, batch))
+			Process(writer, batch);
+	}
+};
+
+NativeWriteBatcher::NativeWriteBatcher(WT_CONNECTION* connection, int writers, int maxBatch, int maxDelayMicroseconds,
+	const char* commitConfig, NativeCompletionQueue* queue) : state_(new State()) {
+	state_->connection = connection;
+	state_->maxBatch = (size_t)maxBatch;
+	state_->maxDelay = std::chrono::microseconds(maxDelayMicroseconds);
+	state_->commitConfig = commitConfig == nullptr ? "" : commitConfig;
+	state_->queue = queue;
+	state_->stopping = false;
+	state_->writes = 0;
+	state_->transactions = 0;
+	for (int i = 0; i < writers; i++) {
+		WT_SESSION* session;
+		int r = connection->open_session(connection, nullptr, nullptr, &session);
+		if (r != 0) {
+			for (size_t j = 0; j < state_->writers.size(); j++) {
+				state_->writers[j]->session->close(state_->writers[j]->session, nullptr);
+				delete state_->writers[j];
+			}
+			delete state_;
+			throw NativeWiredTigerApiException(r, "connection->open_session");
+		}
+		Writer* writer = new Writer();
+		writer->session = session;
+		writer->sleeping = false;
+		state_->writers.push_back(writer);
+	}
+	for (size_t i = 0; i < state_->writers.size(); i++) {
+		Writer* writer = state_->writers[i];
+		State* state = state_;
+		writer->thread = std::thread([state, writer] { state->Run(writer); });
+	}
+}
+
+NativeWriteBatcher::~NativeWriteBatcher() {
+	state_->stopping = true;
+	for (size_t i = 0; i < state_->writers.size(); i++) {
+		Writer* writer = state_->writers[i];
+		{
+			std::lock_guard<std::mutex> lock(writer->mutex);
+			writer->wake.notify_one();
+		}
+		writer->thread.join();
+		// closing the session closes its cursors
+		writer->session->close(writer->session, nullptr);
+		delete writer;
+	}
+	delete state_;
+}
+
+void NativeWriteBatcher::Enqueue(NativeWriteOpType type, const char* uri, __int64 token,
+	const Byte* key, int keySize, const Byte* value, int valueSize) {
+	WriteOp* op = new WriteOp();
+	op->type = type;
+	op->token = token;
+	op->result = 0;
+	op->uri = uri;
+	op->keySize = keySize;
+	op->data.reserve((size_t)keySize + valueSize);
+	op->data.insert(op->data.end(), key, key + keySize);
+	if (valueSize > 0)
+		op->data.insert(op->data.end(), value, value + valueSize);
+	Writer* writer = state_->writers[HashKey(key, keySize) % state_->writers.size()];
+	writer->queue.Push(op);
+	writer->Wake();
+}
+
+__int64 NativeWriteBatcher::Writes() const {
+	return state_->writes;
+}
+
+__int64 NativeWriteBatcher::Transactions() const {
+	return state_->transactions;
+}
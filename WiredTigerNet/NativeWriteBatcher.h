@@ -0,0 +1,28 @@
+#pragma once
+#include "NativeAsync.h"
+
+enum NativeWriteOpType {
+	NativeWriteInsert,
+	NativeWriteRemove
+};
+
+// Group commit for many producer threads. Producers enqueue writes into lock-free queues,
+// writer threads each owning a session apply up to maxBatch writes in a single transaction
+// and post a completion per write once the transaction is committed. Writes are sharded
+// between writers by key hash, so writes to the same key are applied in enqueue order.
+class NativeWriteBatcher {
+public:
+	NativeWriteBatcher(WT_CONNECTION* connection, int writers, int maxBatch, int maxDelayMicroseconds,
+		const char* commitConfig, NativeCompletionQueue* queue);
+	// Commits the writes enqueued so far and stops the writers
+	~NativeWriteBatcher();
+	void Enqueue(NativeWriteOpType type, const char* uri, __int64 token,
+		const Byte* key, int keySize, const Byte* value, int valueSize);
+	__int64 Writes() const;
+	__int64 Transactions() const;
+private:
+	struct State;
+	NativeWriteBatcher(const NativeWriteBatcher&);
+	NativeWriteBatcher& operator=(const NativeWriteBatcher&);
+	State* state_;
+};
@@ -1,9 +1,18 @@
 #include "NativeTiger.h"
+#include "NativeBulkLoader.h"
+#include "NativeAsync.h"
+#include "NativeWriteBatcher.h"
+#include "NativeLatency.h"
+#include "NativeEventRing.h"
+#include "NativeProgress.h"
+#include "NativeParallel.h"
+#include "NativeRanges.h"
 #include "WiredTigerNet.h"
 #include "msclr\marshal_cppstd.h"
 #include "msclr\marshal.h"
 #include <string>
 #include <cstring>
+#include <vector>
 
 using namespace WiredTigerNet;
 
@@ -61,11 +70,17 @@ WiredTigerApiException::WiredTigerApiException(int errorCode, System::String^ ap
 	: errorCode_(errorCode), apiName_(apiName), WiredTigerException(FormatMessage(errorCode, apiName)) {
 }
 
+static bool can_use_referenced_objects() {
+	bool isFinalizingForUnload = System::AppDomain::CurrentDomain->IsFinalizingForUnload();
+	bool hasShutdownStarted = System::Environment::HasShutdownStarted;
+	return !isFinalizingForUnload && !hasShutdownStarted;
+}
+
 // *************
 // WiredTigerComponent
 // *************
 
-WiredTigerComponent::WiredTigerComponent(WiredTigerComponent^ parent) :disposed_(false), parent_(parent) {
+WiredTigerComponent::WiredTigerComponent(WiredTigerComponent^ parent) :disposed_(false), finalizing_(false), parent_(parent) {
 }
 
 WiredTigerComponent::~WiredTigerComponent() {
@@ -83,6 +98,7 @@ WiredTigerComponent::~WiredTigerComponent() {
 WiredTigerComponent::!WiredTigerComponent() {
 	if (IsDisposed())
 		return;
+	finalizing_ = true;
 	try {
 		this->Close();
 	}
@@ -95,6 +111,10 @@ bool WiredTigerComponent::IsDisposed() {
 	return disposed_ || (parent_ != nullptr && parent_->IsDisposed());
 }
 
+bool WiredTigerComponent::IsFinalizing() {
+	return finalizing_;
+}
+
 // *************
 // Boundary/Range
 // *************
@@ -282,6 +302,117 @@ System::Nullable<Boundary> RangeOperators::Inclusive(System::Nullable<Boundary>
 	return !boundary.HasValue || boundary.Value.Inclusive ? boundary : Boundary(boundary.Value.Bytes, true);
 }
 
+// *************
+// ByteView
+// *************
+
+ByteView::ByteView(const Byte* data, int length) : data_(data), length_(length) {
+}
+
+array<Byte>^ ByteView::ToArray() {
+	array<Byte>^ result = gcnew array<Byte>(length_);
+	if (length_ > 0) {
+		pin_ptr<Byte> resultPtr = &result[0];
+		memcpy(resultPtr, data_, length_);
+	}
+	return result;
+}
+
+void ByteView::CopyTo(array<Byte>^ target, int offset) {
+	if (offset < 0 || target->Length - offset < length_)
+		throw gcnew System::ArgumentOutOfRangeException("offset", "target array is too small for the view");
+	if (length_ > 0) {
+		pin_ptr<Byte> targetPtr = &target[offset];
+		memcpy(targetPtr, data_, length_);
+	}
+}
+
+int ByteView::CompareTo(array<Byte>^ other) {
+	if (other->Length == 0)
+		return length_ == 0 ? 0 : 1;
+	//an empty view may have no data pointer
+	if (length_ == 0)
+		return -1;
+	pin_ptr<Byte> otherPtr = &other[0];
+	int result = memcmp(data_, otherPtr, length_ < other->Length ? length_ : other->Length);
+	if (result != 0 || length_ == other->Length)
+		return result;
+	return length_ < other->Length ? -1 : 1;
+}
+
+bool ByteView::SequenceEqual(array<Byte>^ other) {
+	return other->Length == length_ && CompareTo(other) == 0;
+}
+
+// *************
+// KeyValueBatch
+// *************
+
+KeyValueBatch::KeyValueBatch(int maxRows) {
+	Init(maxRows, 64 * 1024);
+}
+
+KeyValueBatch::KeyValueBatch(int maxRows, int initialBufferSize) {
+	Init(maxRows, initialBufferSize);
+}
+
+void KeyValueBatch::Init(int maxRows, int initialBufferSize) {
+	if (maxRows <= 0)
+		throw gcnew System::ArgumentOutOfRangeException("maxRows", "maxRows must be positive");
+	if (initialBufferSize <= 0)
+		throw gcnew System::ArgumentOutOfRangeException("initialBufferSize", "initialBufferSize must be positive");
+	maxRows_ = maxRows;
+	count_ = 0;
+	buffer_ = gcnew array<Byte>(initialBufferSize);
+	offsets_ = gcnew array<int>(2 * maxRows + 1);
+}
+
+void KeyValueBatch::CheckIndex(int index) {
+	if (index < 0 || index >= count_)
+		throw gcnew System::ArgumentOutOfRangeException("index");
+}
+
+int KeyValueBatch::KeyOffset(int index) {
+	CheckIndex(index);
+	return offsets_[2 * index];
+}
+
+int KeyValueBatch::KeyLength(int index) {
+	CheckIndex(index);
+	return offsets_[2 * index + 1] - offsets_[2 * index];
+}
+
+int KeyValueBatch::ValueOffset(int index) {
+	CheckIndex(index);
+	return offsets_[2 * index + 1];
+}
+
+int KeyValueBatch::ValueLength(int index) {
+	CheckIndex(index);
+	return offsets_[2 * index + 2] - offsets_[2 * index + 1];
+}
+
+array<Byte>^ KeyValueBatch::Slice(int from, int to) {
+	array<Byte>^ result = gcnew array<Byte>(to - from);
+	System::Array::Copy(buffer_, from, result, 0, to - from);
+	return result;
+}
+
+array<Byte>^ KeyValueBatch::GetKey(int index) {
+	CheckIndex(index);
+	return Slice(offsets_[2 * index], offsets_[2 * index + 1]);
+}
+
+array<Byte>^ KeyValueBatch::GetValue(int index) {
+	CheckIndex(index);
+	return Slice(offsets_[2 * index + 1], offsets_[2 * index + 2]);
+}
+
+void KeyValueBatch::Grow(int requiredSize) {
+	int newSize = buffer_->Length * 2;
+	buffer_ = gcnew array<Byte>(newSize < requiredSize ? requiredSize : newSize);
+}
+
 // *************
 // Cursor
 // *************
@@ -290,7 +421,7 @@ static bool is_raw_bytes(const char* format) {
 	return strcmp(format, "u") == 0 || strcmp(format, "U") == 0;
 }
 
-Cursor::Cursor(NativeCursor* cursor, WiredTigerComponent^ session) : cursor_(cursor), WiredTigerComponent(session) {
+Cursor::Cursor(NativeCursor* cursor, WiredTigerComponent^ session) : cursor_(cursor), cache_(nullptr), WiredTigerComponent(session) {
 	if (is_raw_bytes(cursor->KeyFormat()) && is_raw_bytes(cursor->ValueFormat()))
 		schemaType_ = CursorSchemaType::KeyAndValue;
 	else if (is_raw_bytes(cursor->KeyFormat()) && strcmp(cursor->ValueFormat(), "") == 0)
@@ -306,7 +437,11 @@ Cursor::Cursor(NativeCursor* cursor, WiredTigerComponent^ session) : cursor_(cur
 
 void Cursor::Close() {
 	if (cursor_ != nullptr) {
-		delete cursor_;
+		//the cache belongs to the session's thread, the finalizer thread must not touch it
+		if (cache_ != nullptr && !IsFinalizing())
+			cache_->Release(cursor_);
+		else
+			delete cursor_;
 		cursor_ = nullptr;
 	}
 }
@@ -339,6 +474,178 @@ void Cursor::Remove(array<Byte>^ key) {
 	INVOKE_NATIVE(cursor_->Remove(keyPtr, key->Length))
 }
 
+int Cursor::TryInsert(array<Byte>^ key, array<Byte>^ value) {
+	if (schemaType_ == CursorSchemaType::KeyOnly)
+		throw gcnew WiredTigerException("invalid TryInsert overload, current schema is [CursorSchemaType.KeyOnly] so use TryInsert(byte[]) instead");
+	pin_ptr<Byte> keyPtr = &key[0];
+	pin_ptr<Byte> valuePtr = &value[0];
+	return cursor_->TryInsert(keyPtr, key->Length, valuePtr, value->Length);
+}
+
+int Cursor::TryInsert(array<Byte>^ key) {
+	if (schemaType_ == CursorSchemaType::KeyAndValue)
+		throw gcnew WiredTigerException("invalid TryInsert overload, current schema is [CursorSchemaType.KeyAndValue] so use TryInsert(byte[],byte[]) instead");
+	pin_ptr<Byte> keyPtr = &key[0];
+	return cursor_->TryInsert(keyPtr, key->Length);
+}
+
+int Cursor::TryRemove(array<Byte>^ key) {
+	pin_ptr<Byte> keyPtr = &key[0];
+	return cursor_->TryRemove(keyPtr, key->Length);
+}
+
+#define PIN_OR_NULL(name, type, source) \
+	pin_ptr<type> name; \
+	if (source != nullptr && source->Length > 0) \
+		name = &source[0]; \
+
+static int packed_count(array<Byte>^ blob, array<int>^ offsets, System::String^ offsetsName) {
+	if (blob == nullptr)
+		throw gcnew System::InvalidOperationException("packed bytes can't be null");
+	if (offsets == nullptr || offsets->Length == 0)
+		throw gcnew System::InvalidOperationException("parameter [" + offsetsName + "] can't be null or empty");
+	int count = offsets->Length - 1;
+	if (offsets[0] < 0 || offsets[count] > blob->Length)
+		throw gcnew System::ArgumentOutOfRangeException(offsetsName, "offsets exceed packed bytes");
+	for (int i = 0; i < count; i++)
+		if (offsets[i] > offsets[i + 1])
+			throw gcnew System::ArgumentOutOfRangeException(offsetsName, "offsets must not decrease");
+	return count;
+}
+
+static void check_statuses(array<int>^ statuses, int count) {
+	if (statuses != nullptr && statuses->Length < count)
+		throw gcnew System::ArgumentOutOfRangeException("statuses", "statuses array is shorter than the batch");
+}
+
+int Cursor::InsertBatch(array<Byte>^ keys, array<int>^ keyOffsets, array<Byte>^ values, array<int>^ valueOffsets, bool sort, array<int>^ statuses) {
+	if (schemaType_ == CursorSchemaType::KeyOnly)
+		throw gcnew WiredTigerException("invalid InsertBatch overload, current schema is [CursorSchemaType.KeyOnly] so use InsertBatch(byte[],int[],bool,int[]) instead");
+	int count = packed_count(keys, keyOffsets, "keyOffsets");
+	if (packed_count(values, valueOffsets, "valueOffsets") != count)
+		throw gcnew System::ArgumentException("keys and values counts differ");
+	check_statuses(statuses, count);
+	if (count == 0)
+		return 0;
+	PIN_OR_NULL(keysPtr, Byte, keys)
+	PIN_OR_NULL(valuesPtr, Byte, values)
+	pin_ptr<int> keyOffsetsPtr = &keyOffsets[0];
+	pin_ptr<int> valueOffsetsPtr = &valueOffsets[0];
+	PIN_OR_NULL(statusesPtr, int, statuses)
+	INVOKE_NATIVE(return cursor_->InsertBatch(keysPtr, keyOffsetsPtr, valuesPtr, valueOffsetsPtr, count, sort, statusesPtr))
+}
+
+int Cursor::InsertBatch(array<Byte>^ keys, array<int>^ keyOffsets, bool sort, array<int>^ statuses) {
+	if (schemaType_ == CursorSchemaType::KeyAndValue)
+		throw gcnew WiredTigerException("invalid InsertBatch overload, current schema is [CursorSchemaType.KeyAndValue] so use InsertBatch(byte[],int[],byte[],int[],bool,int[]) instead");
+	int count = packed_count(keys, keyOffsets, "keyOffsets");
+	check_statuses(statuses, count);
+	if (count == 0)
+		return 0;
+	PIN_OR_NULL(keysPtr, Byte, keys)
+	pin_ptr<int> keyOffsetsPtr = &keyOffsets[0];
+	PIN_OR_NULL(statusesPtr, int, statuses)
+	INVOKE_NATIVE(return cursor_->InsertBatch(keysPtr, keyOffsetsPtr, nullptr, nullptr, count, sort, statusesPtr))
+}
+
+int Cursor::RemoveBatch(array<Byte>^ keys, array<int>^ keyOffsets, bool sort, array<int>^ statuses) {
+	int count = packed_count(keys, keyOffsets, "keyOffsets");
+	check_statuses(statuses, count);
+	if (count == 0)
+		return 0;
+	PIN_OR_NULL(keysPtr, Byte, keys)
+	pin_ptr<int> keyOffsetsPtr = &keyOffsets[0];
+	PIN_OR_NULL(statusesPtr, int, statuses)
+	INVOKE_NATIVE(return cursor_->RemoveBatch(keysPtr, keyOffsetsPtr, count, sort, statusesPtr))
+}
+
+static void check_modify_entries(array<int>^ offsets, array<int>^ sizes, int count) {
+	if (offsets == nullptr || sizes == nullptr)
+		throw gcnew System::InvalidOperationException("parameters [offsets] and [sizes] can't be null");
+	if (offsets->Length != count || sizes->Length != count)
+		throw gcnew System::ArgumentException("offsets, sizes and data must have the same length");
+	for (int i = 0; i < count; i++)
+		if (offsets[i] < 0 || sizes[i] < 0)
+			throw gcnew System::ArgumentOutOfRangeException("offsets and sizes must not be negative");
+}
+
+// Packs data arrays into packedData, entries point into it
+static void build_modify_entries(array<int>^ offsets, array<int>^ sizes, array<array<Byte>^>^ data,
+	std::vector<Byte>& packedData, std::vector<WT_MODIFY>& entries) {
+	if (data == nullptr)
+		throw gcnew System::InvalidOperationException("parameter [data] can't be null");
+	int count = data->Length;
+	check_modify_entries(offsets, sizes, count);
+	std::vector<size_t> dataOffsets(count + 1);
+	for (int i = 0; i < count; i++) {
+		dataOffsets[i] = packedData.size();
+		if (data[i] != nullptr && data[i]->Length > 0) {
+			pin_ptr<Byte> dataPtr = &data[i][0];
+			packedData.insert(packedData.end(), (Byte*)dataPtr, (Byte*)dataPtr + data[i]->Length);
+		}
+	}
+	dataOffsets[count] = packedData.size();
+	entries.resize(count);
+	for (int i = 0; i < count; i++) {
+		memset(&entries[i], 0, sizeof(WT_MODIFY));
+		entries[i].data.data = packedData.data() + dataOffsets[i];
+		entries[i].data.size = dataOffsets[i + 1] - dataOffsets[i];
+		entries[i].offset = offsets[i];
+		entries[i].size = sizes[i];
+	}
+}
+
+bool Cursor::Modify(array<Byte>^ key, array<int>^ offsets, array<int>^ sizes, array<array<Byte>^>^ data) {
+	if (schemaType_ == CursorSchemaType::KeyOnly)
+		throw gcnew WiredTigerException("for current schema [CursorSchemaType.KeyOnly] value is not defined");
+	std::vector<Byte> packedData;
+	std::vector<WT_MODIFY> entries;
+	build_modify_entries(offsets, sizes, data, packedData, entries);
+	pin_ptr<Byte> keyPtr = &key[0];
+	INVOKE_NATIVE(return cursor_->Modify(keyPtr, key->Length, entries.data(), (int)entries.size()))
+}
+
+int Cursor::TryModify(array<Byte>^ key, array<int>^ offsets, array<int>^ sizes, array<array<Byte>^>^ data) {
+	if (schemaType_ == CursorSchemaType::KeyOnly)
+		throw gcnew WiredTigerException("for current schema [CursorSchemaType.KeyOnly] value is not defined");
+	std::vector<Byte> packedData;
+	std::vector<WT_MODIFY> entries;
+	build_modify_entries(offsets, sizes, data, packedData, entries);
+	pin_ptr<Byte> keyPtr = &key[0];
+	return cursor_->TryModify(keyPtr, key->Length, entries.data(), (int)entries.size());
+}
+
+int Cursor::ModifyBatch(array<Byte>^ keys, array<int>^ keyOffsets, array<int>^ entryOffsets,
+	array<int>^ offsets, array<int>^ sizes, array<Byte>^ data, array<int>^ dataOffsets, bool sort, array<int>^ statuses) {
+	if (schemaType_ == CursorSchemaType::KeyOnly)
+		throw gcnew WiredTigerException("for current schema [CursorSchemaType.KeyOnly] value is not defined");
+	int count = packed_count(keys, keyOffsets, "keyOffsets");
+	int entryCount = packed_count(data, dataOffsets, "dataOffsets");
+	check_modify_entries(offsets, sizes, entryCount);
+	if (entryOffsets == nullptr || entryOffsets->Length != count + 1)
+		throw gcnew System::ArgumentException("entryOffsets must have one element more than keys");
+	for (int i = 0; i < count; i++)
+		if (entryOffsets[i] < 0 || entryOffsets[i] > entryOffsets[i + 1] || entryOffsets[i + 1] > entryCount)
+			throw gcnew System::ArgumentOutOfRangeException("entryOffsets");
+	check_statuses(statuses, count);
+	if (count == 0)
+		return 0;
+	PIN_OR_NULL(dataPtr, Byte, data)
+	std::vector<WT_MODIFY> entries(entryCount);
+	for (int i = 0; i < entryCount; i++) {
+		memset(&entries[i], 0, sizeof(WT_MODIFY));
+		entries[i].data.data = (Byte*)dataPtr + dataOffsets[i];
+		entries[i].data.size = dataOffsets[i + 1] - dataOffsets[i];
+		entries[i].offset = offsets[i];
+		entries[i].size = sizes[i];
+	}
+	PIN_OR_NULL(keysPtr, Byte, keys)
+	pin_ptr<int> keyOffsetsPtr = &keyOffsets[0];
+	pin_ptr<int> entryOffsetsPtr = &entryOffsets[0];
+	PIN_OR_NULL(statusesPtr, int, statuses)
+	INVOKE_NATIVE(return cursor_->ModifyBatch(keysPtr, keyOffsetsPtr, entryOffsetsPtr, entries.data(), count, sort, statusesPtr))
+}
+
 void Cursor::Reset() {
 	INVOKE_NATIVE(cursor_->Reset())
 }
@@ -360,6 +667,52 @@ bool Cursor::SearchNear(array<Byte>^ key, [System::Runtime::InteropServices::Out
 	})
 }
 
+static array<Byte>^ to_array(const void* data, int size) {
+	array<Byte>^ result = gcnew array<Byte>(size);
+	if (size > 0) {
+		pin_ptr<Byte> resultPtr = &result[0];
+		memcpy(resultPtr, data, size);
+	}
+	return result;
+}
+
+bool Cursor::TryGet(array<Byte>^ key, [System::Runtime::InteropServices::OutAttribute] array<Byte>^% value) {
+	if (schemaType_ == CursorSchemaType::KeyOnly)
+		throw gcnew WiredTigerException("for current schema [CursorSchemaType.KeyOnly] value is not defined");
+	WT_ITEM item = { 0 };
+	bool found;
+	pin_ptr<Byte> keyPtr = &key[0];
+	INVOKE_NATIVE(found = cursor_->Get(keyPtr, key->Length, &item))
+	value = found ? to_array(item.data, (int)item.size) : nullptr;
+	return found;
+}
+
+array<array<Byte>^>^ Cursor::MultiGet(array<array<Byte>^>^ keys) {
+	if (schemaType_ == CursorSchemaType::KeyOnly)
+		throw gcnew WiredTigerException("for current schema [CursorSchemaType.KeyOnly] value is not defined");
+	int count = keys->Length;
+	array<array<Byte>^>^ result = gcnew array<array<Byte>^>(count);
+	if (count == 0)
+		return result;
+	std::vector<Byte> packedKeys;
+	std::vector<int> keyOffsets(count + 1);
+	for (int i = 0; i < count; i++) {
+		array<Byte>^ key = keys[i];
+		keyOffsets[i] = (int)packedKeys.size();
+		pin_ptr<Byte> keyPtr = &key[0];
+		packedKeys.insert(packedKeys.end(), (Byte*)keyPtr, (Byte*)keyPtr + key->Length);
+	}
+	keyOffsets[count] = (int)packedKeys.size();
+	std::vector<Byte> values;
+	std::vector<int> valueOffsets(count);
+	std::vector<int> valueSizes(count);
+	INVOKE_NATIVE(cursor_->MultiGet(packedKeys.data(), keyOffsets.data(), count, values, valueOffsets.data(), valueSizes.data()))
+	for (int i = 0; i < count; i++)
+		if (valueOffsets[i] >= 0)
+			result[i] = to_array(values.data() + valueOffsets[i], valueSizes[i]);
+	return result;
+}
+
 __int64 Cursor::GetTotalCount(Range range) {
 	return GetTotalCount(range, INT64_MAX);
 }
@@ -373,6 +726,41 @@ __int64 Cursor::GetTotalCount(Range range, __int64 maxCount) {
 		maxCount));
 }
 
+__int64 Cursor::GetTotalCount(RangeSet^ ranges) {
+	return GetTotalCount(ranges, INT64_MAX);
+}
+
+__int64 Cursor::GetTotalCount(RangeSet^ ranges, __int64 maxCount) {
+	if (ranges == nullptr)
+		throw gcnew System::ArgumentNullException("ranges");
+	__int64 result;
+	INVOKE_NATIVE(result = cursor_->GetTotalCount(ranges->NativeSet(), maxCount));
+	System::GC::KeepAlive(ranges);
+	return result;
+}
+
+CountEstimate Cursor::EstimateCount(Range range, double errorBudget) {
+	return EstimateCount(range, errorBudget, -1);
+}
+
+CountEstimate Cursor::EstimateCount(Range range, double errorBudget, __int64 totalCount) {
+	if (errorBudget <= 0 || errorBudget >= 1)
+		throw gcnew System::ArgumentOutOfRangeException("errorBudget", "errorBudget must be between 0 and 1");
+	RANGE_UNWRAP()
+
+	NativeCountEstimate estimate;
+	INVOKE_NATIVE(estimate = cursor_->EstimateCount(
+		leftPtr, leftSize, range.Left.HasValue && range.Left.Value.Inclusive,
+		rightPtr, rightSize, range.Right.HasValue && range.Right.Value.Inclusive,
+		errorBudget, totalCount));
+	CountEstimate result;
+	result.Estimate = estimate.estimate;
+	result.Lower = estimate.lower;
+	result.Upper = estimate.upper;
+	result.IsExact = estimate.exact;
+	return result;
+}
+
 bool Cursor::IterationBegin(Range range, Direction direction) {
 	RANGE_UNWRAP()
 
@@ -382,187 +770,1091 @@ bool Cursor::IterationBegin(Range range, Direction direction) {
 		rightPtr, rightSize, range.Right.HasValue && range.Right.Value.Inclusive, nativeDirection, true));
 }
 
-bool Cursor::IterationMove() {
-	INVOKE_NATIVE(return cursor_->IterationMove())
-}
-
-array<Byte>^ Cursor::GetKey() {
-	WT_ITEM item = { 0 };
-	INVOKE_NATIVE(cursor_->GetKey(&item));
-	array<Byte>^ result = gcnew array<Byte>((int)item.size);
-	if (item.size > 0) {
-		pin_ptr<Byte> resultPtr = &result[0];
-		memcpy(resultPtr, item.data, item.size);
-	}
-	return result;
+static NativeRange to_native_range(Range range) {
+	RANGE_UNWRAP()
+	return MakeNativeRange(leftPtr, leftSize, range.Left.HasValue && range.Left.Value.Inclusive,
+		rightPtr, rightSize, range.Right.HasValue && range.Right.Value.Inclusive);
 }
 
-array<Byte>^ Cursor::GetValue() {
-	if (schemaType_ == CursorSchemaType::KeyOnly)
-		throw gcnew WiredTigerException("for current schema [CursorSchemaType.KeyOnly] value is not defined");
-	WT_ITEM item = { 0 };
-	INVOKE_NATIVE(cursor_->GetValue(&item))
-	array<Byte>^ result = gcnew array<Byte>((int)item.size);
-	if (item.size > 0) {
-		pin_ptr<Byte> resultPtr = &result[0];
-		memcpy(resultPtr, item.data, item.size);
-	}
+static std::vector<NativeRange> to_native_ranges(array<Range>^ ranges) {
+	if (ranges == nullptr)
+		throw gcnew System::ArgumentNullException("ranges");
+	std::vector<NativeRange> result;
+	result.reserve(ranges->Length);
+	for (int i = 0; i < ranges->Length; i++)
+		result.push_back(to_native_range(ranges[i]));
 	return result;
 }
 
 // *************
-// Session
+// RangeSet
 // *************
 
-Session::Session(WT_SESSION *session, WiredTigerComponent^ connection) : session_(session), WiredTigerComponent(connection) {
+RangeSet::RangeSet() : set_(new NativeRangeSet()) {
 }
 
-void Session::Close() {
-	if (session_ != nullptr) {
-		session_->close(session_, nullptr);
-		session_ = nullptr;
+RangeSet::RangeSet(System::Collections::Generic::IEnumerable<Range>^ ranges) : set_(nullptr) {
+	if (ranges == nullptr)
+		throw gcnew System::ArgumentNullException("ranges");
+	std::vector<NativeRange> nativeRanges;
+	for each (Range range in ranges)
+		nativeRanges.push_back(to_native_range(range));
+	set_ = new NativeRangeSet(nativeRanges);
+}
+
+RangeSet::RangeSet(NativeRangeSet* set) : set_(set) {
+}
+
+RangeSet::~RangeSet() {
+	this->!RangeSet();
+}
+
+RangeSet::!RangeSet() {
+	if (set_ != nullptr) {
+		delete set_;
+		set_ = nullptr;
 	}
 }
 
-void Session::BeginTran() {
-	int r = session_->begin_transaction(session_, nullptr);
-	if (r != 0)
-		throw gcnew WiredTigerApiException(r, "session->begin_transaction");
+const NativeRangeSet& RangeSet::NativeSet() {
+	if (set_ == nullptr)
+		throw gcnew System::ObjectDisposedException("RangeSet");
+	return *set_;
 }
 
-void Session::CommitTran() {
-	int r = session_->commit_transaction(session_, nullptr);
-	if (r != 0)
-		throw gcnew WiredTigerApiException(r, "session->commit_transaction");
+int RangeSet::Count::get() {
+	return NativeSet().Count();
 }
 
-void Session::RollbackTran() {
-	int r = session_->rollback_transaction(session_, nullptr);
-	if (r != 0)
-		throw gcnew WiredTigerApiException(r, "session->rollback_transaction");
+static System::Nullable<Boundary> to_boundary(const NativeBound& bound) {
+	if (!bound.bounded)
+		return System::Nullable<Boundary>();
+	return Boundary(to_array(bound.data, bound.size), bound.inclusive);
 }
 
-static std::string str_or_empty(System::String^ s) {
-	std::string result(msclr::interop::marshal_as<std::string>(s == nullptr ? "" : s));
+Range RangeSet::default::get(int index) {
+	const NativeRangeSet& set = NativeSet();
+	if (index < 0 || index >= set.Count())
+		throw gcnew System::ArgumentOutOfRangeException("index", "index must be less than Count");
+	Range result(to_boundary(set.Left(index)), to_boundary(set.Right(index)));
+	System::GC::KeepAlive(this);
 	return result;
 }
 
-static std::string str_or_die(System::String^ s, System::String^ parameterName) {
-	if (s == nullptr)
-		throw gcnew System::InvalidOperationException("parameter [" + parameterName + "] can't be null");
-	std::string result(msclr::interop::marshal_as<std::string>(s));
+bool RangeSet::Contains(array<Byte>^ key) {
+	if (key == nullptr)
+		throw gcnew System::ArgumentNullException("key");
+	const NativeRangeSet& set = NativeSet();
+	bool result;
+	if (key->Length == 0)
+		result = set.Contains(nullptr, 0);
+	else {
+		pin_ptr<Byte> keyPtr = &key[0];
+		result = set.Contains(keyPtr, key->Length);
+	}
+	System::GC::KeepAlive(this);
 	return result;
 }
 
-void Session::Checkpoint(System::String^ config) {
-	std::string configStr(str_or_empty(config));
-	int r = session_->checkpoint(session_, configStr.c_str());
-	if (r != 0)
-		throw gcnew WiredTigerApiException(r, "session->checkpoint");
+RangeSet^ RangeSet::Union(RangeSet^ other) {
+	if (other == nullptr)
+		throw gcnew System::ArgumentNullException("other");
+	NativeRangeSet* result = new NativeRangeSet();
+	NativeRangeSet::Union(NativeSet(), other->NativeSet(), *result);
+	System::GC::KeepAlive(this);
+	System::GC::KeepAlive(other);
+	return gcnew RangeSet(result);
 }
 
-void Session::Compact(System::String^ name, System::String^ config) {
-	std::string nameStr(str_or_empty(name));
-	std::string configStr(str_or_empty(config));
-	int r = session_->compact(session_, nameStr.c_str(), configStr.c_str());
-	if (r != 0)
-		throw gcnew WiredTigerApiException(r, "session->compact" + ", " + name);
+RangeSet^ RangeSet::Intersect(RangeSet^ other) {
+	if (other == nullptr)
+		throw gcnew System::ArgumentNullException("other");
+	NativeRangeSet* result = new NativeRangeSet();
+	NativeRangeSet::Intersect(NativeSet(), other->NativeSet(), *result);
+	System::GC::KeepAlive(this);
+	System::GC::KeepAlive(other);
+	return gcnew RangeSet(result);
 }
 
-void Session::Create(System::String^ name, System::String^ config) {
-	std::string nameStr(str_or_die(name, "name"));
-	std::string configStr(str_or_empty(config));
-	int r = session_->create(session_, nameStr.c_str(), configStr.c_str());
-	if (r != 0)
-		throw gcnew WiredTigerApiException(r, "session->create" + ", " + name);
+RangeSet^ RangeSet::Difference(RangeSet^ other) {
+	if (other == nullptr)
+		throw gcnew System::ArgumentNullException("other");
+	NativeRangeSet* result = new NativeRangeSet();
+	NativeRangeSet::Difference(NativeSet(), other->NativeSet(), *result);
+	System::GC::KeepAlive(this);
+	System::GC::KeepAlive(other);
+	return gcnew RangeSet(result);
 }
 
-void Session::Drop(System::String^ name, System::String^ config) {
-	std::string nameStr(str_or_die(name, "name"));
-	std::string configStr(str_or_empty(config));
-	int r = session_->drop(session_, nameStr.c_str(), configStr.c_str());
-	if (r != 0)
-		throw gcnew WiredTigerApiException(r, "session->drop" + ", " + name);
+RangeSet^ RangeSet::Complement() {
+	NativeRangeSet* result = new NativeRangeSet();
+	NativeRangeSet::Complement(NativeSet(), *result);
+	System::GC::KeepAlive(this);
+	return gcnew RangeSet(result);
 }
 
-void Session::Rename(System::String^ oldName, System::String^ newName, System::String^ config) {
-	std::string oldNameStr(str_or_die(oldName, "oldName"));
-	std::string newNameStr(str_or_die(newName, "newName"));
-	std::string configStr(str_or_empty(config));
-	int r = session_->rename(session_, oldNameStr.c_str(), newNameStr.c_str(), configStr.c_str());
-	if (r != 0)
-		throw gcnew WiredTigerApiException(r, "session->rename" + ", " + oldName + "->" + newName);
+array<Range>^ RangeSet::ToArray() {
+	array<Range>^ result = gcnew array<Range>(Count);
+	for (int i = 0; i < result->Length; i++)
+		result[i] = this->default[i];
+	return result;
 }
 
-void Session::Upgrade(System::String^ name, System::String^ config) {
-	std::string nameStr(str_or_die(name, "name"));
-	std::string configStr(str_or_empty(config));
-	int r = session_->upgrade(session_, nameStr.c_str(), configStr.c_str());
-	if (r != 0)
-		throw gcnew WiredTigerApiException(r, "session->upgrade" + ", " + name);
+bool Cursor::IterationBegin(array<Range>^ ranges, Direction direction) {
+	std::vector<NativeRange> nativeRanges(to_native_ranges(ranges));
+	NativeDirection nativeDirection = direction == Direction::Ascending ? Ascending : Descending;
+	INVOKE_NATIVE(return cursor_->IterationBegin(nativeRanges, nativeDirection));
 }
 
-void Session::Verify(System::String^ name, System::String^ config) {
-	std::string nameStr(str_or_die(name, "name"));
-	std::string configStr(str_or_empty(config));
-	int r = session_->verify(session_, nameStr.c_str(), configStr.c_str());
-	if (r != 0)
-		throw gcnew WiredTigerApiException(r, "session->verify" + ", " + name);
+bool Cursor::IterationBegin(RangeSet^ ranges, Direction direction) {
+	if (ranges == nullptr)
+		throw gcnew System::ArgumentNullException("ranges");
+	NativeDirection nativeDirection = direction == Direction::Ascending ? Ascending : Descending;
+	bool result;
+	INVOKE_NATIVE(result = cursor_->IterationBegin(ranges->NativeSet(), nativeDirection));
+	System::GC::KeepAlive(ranges);
+	return result;
 }
 
-Cursor^ Session::OpenCursor(System::String^ name) {
-	std::string nameStr(str_or_die(name, "name"));
-	NativeCursor* nativeCursor;
-	INVOKE_NATIVE(nativeCursor = OpenNativeCursor(session_, nameStr.c_str(), nullptr))
-	return gcnew Cursor(nativeCursor, this);
+bool Cursor::IterationMove() {
+	INVOKE_NATIVE(return cursor_->IterationMove())
 }
 
-Cursor^ Session::OpenCursor(System::String^ name, System::String^ config) {
-	std::string nameStr(str_or_die(name, "name"));
-	std::string configStr(str_or_die(config, "config"));
-	NativeCursor* nativeCursor;
-	INVOKE_NATIVE(nativeCursor = OpenNativeCursor(session_, nameStr.c_str(), configStr.c_str()))
-	return gcnew Cursor(nativeCursor, this);
+int Cursor::ReadBatch(Range range, Direction direction, KeyValueBatch^ batch) {
+	if (!IterationBegin(range, direction)) {
+		batch->count_ = 0;
+		return 0;
+	}
+	return ReadBatch(batch);
 }
 
-// *************
-// Connection
-// *************
-template<typename T>
-static T to_pointer(System::Delegate^ d) {
-	return (T)System::Runtime::InteropServices::Marshal::GetFunctionPointerForDelegate(d).ToPointer();
+int Cursor::ReadBatch(array<Range>^ ranges, Direction direction, KeyValueBatch^ batch) {
+	if (!IterationBegin(ranges, direction)) {
+		batch->count_ = 0;
+		return 0;
+	}
+	return ReadBatch(batch);
 }
 
-Connection::Connection(System::String^ closeConfig, IEventHandler^ eventHandler)
-	:eventHandler_(eventHandler),
-	closeConfig_(closeConfig),
-	onErrorDelegate_(gcnew OnErrorDelegate(this, &Connection::OnError)),
+int Cursor::ReadBatch(RangeSet^ ranges, Direction direction, KeyValueBatch^ batch) {
+	if (!IterationBegin(ranges, direction)) {
+		batch->count_ = 0;
+		return 0;
+	}
+	return ReadBatch(batch);
+}
+
+int Cursor::ReadBatch(KeyValueBatch^ batch) {
+	int count;
+	int requiredSize;
+	while (true) {
+		pin_ptr<Byte> bufferPtr = &batch->buffer_[0];
+		pin_ptr<int> offsetsPtr = &batch->offsets_[0];
+		INVOKE_NATIVE(count = cursor_->FetchBatch(bufferPtr, batch->buffer_->Length, offsetsPtr, batch->MaxRows, &requiredSize))
+		if (count > 0 || requiredSize == 0)
+			break;
+		batch->Grow(requiredSize);
+	}
+	batch->count_ = count;
+	return count;
+}
+
+array<Byte>^ Cursor::GetKey() {
+	WT_ITEM item = { 0 };
+	INVOKE_NATIVE(cursor_->GetKey(&item));
+	return to_array(item.data, (int)item.size);
+}
+
+array<Byte>^ Cursor::GetValue() {
+	if (schemaType_ == CursorSchemaType::KeyOnly)
+		throw gcnew WiredTigerException("for current schema [CursorSchemaType.KeyOnly] value is not defined");
+	WT_ITEM item = { 0 };
+	INVOKE_NATIVE(cursor_->GetValue(&item))
+	return to_array(item.data, (int)item.size);
+}
+
+#define BUFFER_UNWRAP() \
+	if (offset < 0 || offset > buffer->Length) \
+		throw gcnew System::ArgumentOutOfRangeException("offset"); \
+	int available = buffer->Length - offset; \
+	pin_ptr<Byte> bufferPtr; \
+	if (available > 0) \
+		bufferPtr = &buffer[offset]; \
+
+int Cursor::GetKey(array<Byte>^ buffer, int offset) {
+	BUFFER_UNWRAP()
+	int size;
+	INVOKE_NATIVE(size = cursor_->GetKey(bufferPtr, available))
+	return size <= available ? size : -size;
+}
+
+int Cursor::GetValue(array<Byte>^ buffer, int offset) {
+	if (schemaType_ == CursorSchemaType::KeyOnly)
+		throw gcnew WiredTigerException("for current schema [CursorSchemaType.KeyOnly] value is not defined");
+	BUFFER_UNWRAP()
+	int size;
+	INVOKE_NATIVE(size = cursor_->GetValue(bufferPtr, available))
+	return size <= available ? size : -size;
+}
+
+ByteView Cursor::GetKeyView() {
+	NativeBytes bytes;
+	INVOKE_NATIVE(bytes = cursor_->KeyView())
+	return ByteView(bytes.data, bytes.size);
+}
+
+ByteView Cursor::GetValueView() {
+	if (schemaType_ == CursorSchemaType::KeyOnly)
+		throw gcnew WiredTigerException("for current schema [CursorSchemaType.KeyOnly] value is not defined");
+	NativeBytes bytes;
+	INVOKE_NATIVE(bytes = cursor_->ValueView())
+	return ByteView(bytes.data, bytes.size);
+}
+
+// *************
+// BulkLoader
+// *************
+
+BulkLoader::BulkLoader(NativeBulkLoader* loader, Session^ session) : loader_(loader), session_(session), WiredTigerComponent(session) {
+}
+
+void BulkLoader::Close() {
+	if (!can_use_referenced_objects())
+		return;
+	if (loader_ != nullptr) {
+		delete loader_;
+		loader_ = nullptr;
+	}
+	session_->RemoveBulkLoader(this);
+}
+
+void BulkLoader::Add(array<Byte>^ key, array<Byte>^ value) {
+	pin_ptr<Byte> keyPtr = &key[0];
+	PIN_OR_NULL(valuePtr, Byte, value)
+	INVOKE_NATIVE(loader_->Add(keyPtr, key->Length, valuePtr, value == nullptr ? 0 : value->Length))
+}
+
+void BulkLoader::Add(array<Byte>^ key) {
+	pin_ptr<Byte> keyPtr = &key[0];
+	INVOKE_NATIVE(loader_->Add(keyPtr, key->Length, nullptr, 0))
+}
+
+__int64 BulkLoader::Complete() {
+	INVOKE_NATIVE(return loader_->Complete())
+}
+
+// *************
+// CachedConfig/TransactionOptions/CommitOptions
+// *************
+
+template<typename T>
+static T to_pointer(System::Delegate^ d) {
+	return (T)System::Runtime::InteropServices::Marshal::GetFunctionPointerForDelegate(d).ToPointer();
+}
+
+static std::string str_or_empty(System::String^ s) {
+	std::string result(msclr::interop::marshal_as<std::string>(s == nullptr ? "" : s));
+	return result;
+}
+
+static std::string str_or_die(System::String^ s, System::String^ parameterName) {
+	if (s == nullptr)
+		throw gcnew System::InvalidOperationException("parameter [" + parameterName + "] can't be null");
+	std::string result(msclr::interop::marshal_as<std::string>(s));
+	return result;
+}
+
+CachedConfig::CachedConfig() : config_(nullptr) {
+}
+
+CachedConfig::~CachedConfig() {
+	this->!CachedConfig();
+}
+
+CachedConfig::!CachedConfig() {
+	Invalidate();
+}
+
+void CachedConfig::Invalidate() {
+	if (config_ != nullptr) {
+		delete config_;
+		config_ = nullptr;
+	}
+}
+
+const char* CachedConfig::NativeConfig() {
+	if (config_ == nullptr)
+		config_ = new std::string(str_or_empty(Build()));
+	return config_->c_str();
+}
+
+//copied so the string outlives the options object for the whole native call
+static std::string copy_config(CachedConfig^ options) {
+	std::string result(options == nullptr ? "" : options->NativeConfig());
+	System::GC::KeepAlive(options);
+	return result;
+}
+
+static const char* config_or_null(const std::string& config) {
+	return config.empty() ? nullptr : config.c_str();
+}
+
+static void append_config(System::Text::StringBuilder^ builder, System::String^ name, System::String^ value) {
+	if (builder->Length > 0)
+		builder->Append(",");
+	builder->Append(name)->Append("=")->Append(value);
+}
+
+static System::String^ format_timestamp(System::UInt64 timestamp) {
+	return timestamp.ToString("x");
+}
+
+System::String^ TransactionOptions::Build() {
+	System::Text::StringBuilder^ result = gcnew System::Text::StringBuilder();
+	if (isolation_.HasValue)
+		append_config(result, "isolation", isolation_.Value == IsolationLevel::Snapshot ? "snapshot" :
+			isolation_.Value == IsolationLevel::ReadCommitted ? "read-committed" : "read-uncommitted");
+	if (sync_.HasValue)
+		append_config(result, "sync", sync_.Value ? "true" : "false");
+	if (priority_.HasValue)
+		append_config(result, "priority", priority_.Value.ToString());
+	if (readTimestamp_.HasValue)
+		append_config(result, "read_timestamp", format_timestamp(readTimestamp_.Value));
+	if (name_ != nullptr)
+		append_config(result, "name", "\"" + name_ + "\"");
+	return result->ToString();
+}
+
+System::String^ CommitOptions::Build() {
+	System::Text::StringBuilder^ result = gcnew System::Text::StringBuilder();
+	if (sync_.HasValue)
+		append_config(result, "sync", sync_.Value == CommitSync::On ? "on" :
+			sync_.Value == CommitSync::Off ? "off" : "background");
+	if (commitTimestamp_.HasValue)
+		append_config(result, "commit_timestamp", format_timestamp(commitTimestamp_.Value));
+	return result->ToString();
+}
+
+// *************
+// Session
+// *************
+
+Session::Session(WT_SESSION *session, WiredTigerComponent^ connection) : session_(session), cursorCache_(nullptr), cursorCacheSize_(4), inTransaction_(false),
+	bulkLoaders_(gcnew System::Collections::Generic::List<BulkLoader^>()), WiredTigerComponent(connection) {
+}
+
+static const int tableStatisticsKeys[] = {
+	WT_STAT_DSRC_BLOCK_SIZE,
+	WT_STAT_DSRC_CACHE_BYTES_INUSE,
+	WT_STAT_DSRC_BTREE_MAXIMUM_DEPTH,
+	WT_STAT_DSRC_BTREE_ENTRIES,
+	WT_STAT_DSRC_BTREE_ROW_INTERNAL,
+	WT_STAT_DSRC_BTREE_ROW_LEAF,
+	WT_STAT_DSRC_BTREE_OVERFLOW
+};
+
+TableStatistics Session::GetTableStatistics(System::String^ uri, bool fast) {
+	std::string uriStr(str_or_die(uri, "uri"));
+	const int count = sizeof(tableStatisticsKeys) / sizeof(tableStatisticsKeys[0]);
+	__int64 values[count];
+	INVOKE_NATIVE(ReadStatistics(session_, uriStr.c_str(), fast ? "statistics=(fast)" : nullptr, tableStatisticsKeys, count, values))
+	TableStatistics result;
+	result.FileSize = values[0];
+	result.CacheBytesInUse = values[1];
+	result.MaximumDepth = values[2];
+	result.Entries = values[3];
+	result.InternalPages = values[4];
+	result.LeafPages = values[5];
+	result.OverflowPages = values[6];
+	return result;
+}
+
+static System::Nullable<Boundary> to_boundary(bool has, const std::vector<Byte>& bytes, bool inclusive) {
+	if (!has)
+		return System::Nullable<Boundary>();
+	return Boundary(to_array(bytes.data(), (int)bytes.size()), inclusive);
+}
+
+array<Range>^ Session::GetSplitPoints(System::String^ uri, Range range, int n) {
+	return GetSplitPoints(uri, range, n, SplitBalance::Rows);
+}
+
+array<Range>^ Session::GetSplitPoints(System::String^ uri, Range range, int n, SplitBalance balance) {
+	if (n <= 0)
+		throw gcnew System::ArgumentOutOfRangeException("n", "n must be positive");
+	std::string uriStr(str_or_die(uri, "uri"));
+	NativeRange nativeRange = to_native_range(range);
+	std::vector<std::vector<Byte>> splits;
+	INVOKE_NATIVE(SampleSplitKeys(session_, uriStr.c_str(), nativeRange, n, balance == SplitBalance::Bytes, splits))
+	std::vector<NativeRange> parts;
+	SplitRange(nativeRange, splits, parts);
+	array<Range>^ result = gcnew array<Range>((int)parts.size());
+	for (int i = 0; i < result->Length; i++) {
+		const NativeRange& part = parts[i];
+		result[i] = Range(to_boundary(part.hasLeft, part.left, part.leftInclusive),
+			to_boundary(part.hasRight, part.right, part.rightInclusive));
+	}
+	return result;
+}
+
+void Session::Close() {
+	//loader threads use this session, disposing a loader removes it from the list
+	if (can_use_referenced_objects()) {
+		array<BulkLoader^>^ loaders;
+		System::Threading::Monitor::Enter(bulkLoaders_);
+		try {
+			loaders = bulkLoaders_->ToArray();
+		}
+		finally {
+			System::Threading::Monitor::Exit(bulkLoaders_);
+		}
+		for each (BulkLoader^ loader in loaders)
+			delete loader;
+	}
+	if (cursorCache_ != nullptr) {
+		delete cursorCache_;
+		cursorCache_ = nullptr;
+	}
+	if (session_ != nullptr) {
+		session_->close(session_, nullptr);
+		session_ = nullptr;
+	}
+}
+
+void Session::BeginTran() {
+	int r = session_->begin_transaction(session_, nullptr);
+	if (r != 0)
+		throw gcnew WiredTigerApiException(r, "session->begin_transaction");
+	inTransaction_ = true;
+}
+
+void Session::BeginTran(TransactionOptions^ options) {
+	std::string config(copy_config(options));
+	int r = session_->begin_transaction(session_, config_or_null(config));
+	if (r != 0)
+		throw gcnew WiredTigerApiException(r, "session->begin_transaction");
+	inTransaction_ = true;
+}
+
+void Session::CommitTran() {
+	int r = session_->commit_transaction(session_, nullptr);
+	inTransaction_ = false;
+	if (r != 0)
+		throw gcnew WiredTigerApiException(r, "session->commit_transaction");
+}
+
+void Session::CommitTran(CommitOptions^ options) {
+	std::string config(copy_config(options));
+	int r = session_->commit_transaction(session_, config_or_null(config));
+	inTransaction_ = false;
+	if (r != 0)
+		throw gcnew WiredTigerApiException(r, "session->commit_transaction");
+}
+
+int Session::TryCommitTran() {
+	inTransaction_ = false;
+	return session_->commit_transaction(session_, nullptr);
+}
+
+int Session::TryCommitTran(CommitOptions^ options) {
+	std::string config(copy_config(options));
+	inTransaction_ = false;
+	return session_->commit_transaction(session_, config_or_null(config));
+}
+
+void Session::RollbackTran() {
+	int r = session_->rollback_transaction(session_, nullptr);
+	inTransaction_ = false;
+	if (r != 0)
+		throw gcnew WiredTigerApiException(r, "session->rollback_transaction");
+}
+
+bool Session::ResetForPool() {
+	if (session_ == nullptr)
+		return false;
+	if (inTransaction_) {
+		inTransaction_ = false;
+		if (session_->rollback_transaction(session_, nullptr) != 0)
+			return false;
+	}
+	return session_->reset(session_) == 0;
+}
+
+static const int defaultTransactionAttempts = 10;
+
+int Session::InvokeBody(void*) {
+	try {
+		return body_(this);
+	}
+	catch (WiredTigerApiException^ e) {
+		if (e->ErrorCode != WT_ROLLBACK)
+			bodyException_ = e;
+		return e->ErrorCode;
+	}
+	catch (System::Exception^ e) {
+		//managed exceptions must not unwind through native frames, any code but WT_ROLLBACK stops retries
+		bodyException_ = e;
+		return WT_ERROR;
+	}
+}
+
+int Session::TryRunTransaction(TransactionBody^ body, TransactionOptions^ options, CommitOptions^ commitOptions, int maxAttempts) {
+	if (body == nullptr)
+		throw gcnew System::ArgumentNullException("body");
+	if (maxAttempts <= 0)
+		throw gcnew System::ArgumentOutOfRangeException("maxAttempts", "maxAttempts must be positive");
+	if (body_ != nullptr)
+		throw gcnew System::InvalidOperationException("transactions can't be nested");
+	if (invokeBodyDelegate_ == nullptr)
+		invokeBodyDelegate_ = gcnew InvokeBodyDelegate(this, &Session::InvokeBody);
+	body_ = body;
+	bodyException_ = nullptr;
+	std::string beginConfig(copy_config(options));
+	std::string commitConfig(copy_config(commitOptions));
+	int r;
+	try {
+		r = ::RunTransaction(session_, config_or_null(beginConfig), config_or_null(commitConfig),
+			to_pointer<NativeTransactionBody>(invokeBodyDelegate_), nullptr, maxAttempts, nullptr);
+	}
+	finally {
+		body_ = nullptr;
+	}
+	System::Exception^ exception = bodyException_;
+	bodyException_ = nullptr;
+	if (exception != nullptr && dynamic_cast<WiredTigerApiException^>(exception) == nullptr)
+		System::Runtime::ExceptionServices::ExceptionDispatchInfo::Capture(exception)->Throw();
+	return r;
+}
+
+void Session::RunTransaction(TransactionBody^ body) {
+	int r = TryRunTransaction(body, nullptr, nullptr, defaultTransactionAttempts);
+	if (r != 0)
+		throw gcnew WiredTigerApiException(r, "session->run_transaction");
+}
+
+void Session::PrepareTran(System::UInt64 prepareTimestamp) {
+	std::string configStr(str_or_empty(System::String::Format("prepare_timestamp={0:x}", prepareTimestamp)));
+	int r = session_->prepare_transaction(session_, configStr.c_str());
+	if (r != 0)
+		throw gcnew WiredTigerApiException(r, "session->prepare_transaction");
+}
+
+void Session::TimestampTran(System::String^ config) {
+	std::string configStr(str_or_die(config, "config"));
+	int r = session_->timestamp_transaction(session_, configStr.c_str());
+	if (r != 0)
+		throw gcnew WiredTigerApiException(r, "session->timestamp_transaction");
+}
+
+void Session::TransactionSync(System::String^ config) {
+	std::string configStr(str_or_empty(config));
+	int r = session_->transaction_sync(session_, configStr.c_str());
+	if (r != 0)
+		throw gcnew WiredTigerApiException(r, "session->transaction_sync");
+}
+
+void Session::Checkpoint(System::String^ config) {
+	std::string configStr(str_or_empty(config));
+	int r = session_->checkpoint(session_, configStr.c_str());
+	if (r != 0)
+		throw gcnew WiredTigerApiException(r, "session->checkpoint");
+}
+
+void Session::Compact(System::String^ name, System::String^ config) {
+	std::string nameStr(str_or_empty(name));
+	std::string configStr(str_or_empty(config));
+	int r = session_->compact(session_, nameStr.c_str(), configStr.c_str());
+	if (r != 0)
+		throw gcnew WiredTigerApiException(r, "session->compact" + ", " + name);
+}
+
+void Session::Create(System::String^ name, System::String^ config) {
+	std::string nameStr(str_or_die(name, "name"));
+	std::string configStr(str_or_empty(config));
+	int r = session_->create(session_, nameStr.c_str(), configStr.c_str());
+	if (r != 0)
+		throw gcnew WiredTigerApiException(r, "session->create" + ", " + name);
+}
+
+void Session::Drop(System::String^ name, System::String^ config) {
+	std::string nameStr(str_or_die(name, "name"));
+	std::string configStr(str_or_empty(config));
+	int r = session_->drop(session_, nameStr.c_str(), configStr.c_str());
+	if (r != 0)
+		throw gcnew WiredTigerApiException(r, "session->drop" + ", " + name);
+}
+
+void Session::Rename(System::String^ oldName, System::String^ newName, System::String^ config) {
+	std::string oldNameStr(str_or_die(oldName, "oldName"));
+	std::string newNameStr(str_or_die(newName, "newName"));
+	std::string configStr(str_or_empty(config));
+	int r = session_->rename(session_, oldNameStr.c_str(), newNameStr.c_str(), configStr.c_str());
+	if (r != 0)
+		throw gcnew WiredTigerApiException(r, "session->rename" + ", " + oldName + "->" + newName);
+}
+
+void Session::Truncate(System::String^ name, Range range) {
+	std::string nameStr(str_or_die(name, "name"));
+	RANGE_UNWRAP()
+	INVOKE_NATIVE(TruncateRange(session_, nameStr.c_str(),
+		leftPtr, leftSize, range.Left.HasValue && range.Left.Value.Inclusive,
+		rightPtr, rightSize, range.Right.HasValue && range.Right.Value.Inclusive))
+}
+
+void Session::Upgrade(System::String^ name, System::String^ config) {
+	std::string nameStr(str_or_die(name, "name"));
+	std::string configStr(str_or_empty(config));
+	int r = session_->upgrade(session_, nameStr.c_str(), configStr.c_str());
+	if (r != 0)
+		throw gcnew WiredTigerApiException(r, "session->upgrade" + ", " + name);
+}
+
+void Session::Verify(System::String^ name, System::String^ config) {
+	std::string nameStr(str_or_die(name, "name"));
+	std::string configStr(str_or_empty(config));
+	int r = session_->verify(session_, nameStr.c_str(), configStr.c_str());
+	if (r != 0)
+		throw gcnew WiredTigerApiException(r, "session->verify" + ", " + name);
+}
+
+Cursor^ Session::OpenCursor(System::String^ name) {
+	std::string nameStr(str_or_die(name, "name"));
+	NativeCursor* nativeCursor;
+	INVOKE_NATIVE(nativeCursor = OpenNativeCursor(session_, nameStr.c_str(), nullptr))
+	return gcnew Cursor(nativeCursor, this);
+}
+
+Cursor^ Session::OpenCursor(System::String^ name, System::String^ config) {
+	std::string nameStr(str_or_die(name, "name"));
+	std::string configStr(str_or_die(config, "config"));
+	NativeCursor* nativeCursor;
+	INVOKE_NATIVE(nativeCursor = OpenNativeCursor(session_, nameStr.c_str(), configStr.c_str()))
+	return gcnew Cursor(nativeCursor, this);
+}
+
+Cursor^ Session::OpenCachedCursor(System::String^ name) {
+	return OpenCachedCursor(name, nullptr);
+}
+
+Cursor^ Session::OpenCachedCursor(System::String^ name, System::String^ config) {
+	std::string nameStr(str_or_die(name, "name"));
+	std::string configStr(str_or_empty(config));
+	if (cursorCache_ == nullptr)
+		cursorCache_ = new NativeCursorCache(session_, cursorCacheSize_);
+	NativeCursor* nativeCursor;
+	INVOKE_NATIVE(nativeCursor = cursorCache_->Acquire(nameStr.c_str(), config == nullptr ? nullptr : configStr.c_str()))
+	Cursor^ result = gcnew Cursor(nativeCursor, this);
+	result->cache_ = cursorCache_;
+	return result;
+}
+
+void Session::CursorCacheSize::set(int value) {
+	if (value < 0)
+		throw gcnew System::ArgumentOutOfRangeException("value", "cursor cache size can't be negative");
+	if (cursorCache_ != nullptr)
+		throw gcnew System::InvalidOperationException("cursor cache size can't be changed after the first OpenCachedCursor");
+	cursorCacheSize_ = value;
+}
+
+BulkLoader^ Session::OpenBulkLoader(System::String^ name, System::String^ tempDirectory) {
+	return OpenBulkLoader(name, tempDirectory, 64 * 1024 * 1024, System::Environment::ProcessorCount);
+}
+
+BulkLoader^ Session::OpenBulkLoader(System::String^ name, System::String^ tempDirectory, __int64 runBytes, int threads) {
+	std::string nameStr(str_or_die(name, "name"));
+	std::string tempDirectoryStr(str_or_die(tempDirectory, "tempDirectory"));
+	if (runBytes <= 0)
+		throw gcnew System::ArgumentOutOfRangeException("runBytes", "runBytes must be positive");
+	if (threads <= 0)
+		throw gcnew System::ArgumentOutOfRangeException("threads", "threads must be positive");
+	NativeBulkLoader* loader;
+	INVOKE_NATIVE(loader = OpenNativeBulkLoader(session_, nameStr.c_str(), tempDirectoryStr.c_str(), runBytes, threads))
+	BulkLoader^ result = gcnew BulkLoader(loader, this);
+	System::Threading::Monitor::Enter(bulkLoaders_);
+	try {
+		bulkLoaders_->Add(result);
+	}
+	finally {
+		System::Threading::Monitor::Exit(bulkLoaders_);
+	}
+	return result;
+}
+
+void Session::RemoveBulkLoader(BulkLoader^ loader) {
+	System::Threading::Monitor::Enter(bulkLoaders_);
+	try {
+		bulkLoaders_->Remove(loader);
+	}
+	finally {
+		System::Threading::Monitor::Exit(bulkLoaders_);
+	}
+}
+
+// *************
+// Async operations
+// *************
+
+static const int asyncDispatchBatch = 1024;
+static const int eventDrainBatch = 256;
+static const int progressReportIntervalMilliseconds = 1000;
+
+namespace WiredTigerNet {
+	ref class AsyncOperation abstract {
+	public:
+		AsyncOperation(System::String^ apiName) : apiName_(apiName) {
+		}
+		// set by the dispatcher before Complete
+		int Result;
+		array<Byte>^ Value;
+		virtual void Complete() = 0;
+		virtual void Fail(System::Exception^ exception) = 0;
+	protected:
+		System::Exception^ Error() {
+			return gcnew WiredTigerApiException(Result, apiName_);
+		}
+	private:
+		System::String^ apiName_;
+	};
+
+	ref class SearchOperation : AsyncOperation {
+	public:
+		SearchOperation(System::String^ apiName) : AsyncOperation(apiName),
+			Source(gcnew System::Threading::Tasks::TaskCompletionSource<array<Byte>^>()) {
+		}
+		System::Threading::Tasks::TaskCompletionSource<array<Byte>^>^ Source;
+		virtual void Complete() override {
+			if (Result == 0)
+				Source->TrySetResult(Value != nullptr ? Value : gcnew array<Byte>(0));
+			else if (Result == WT_NOTFOUND)
+				Source->TrySetResult(nullptr);
+			else
+				Source->TrySetException(Error());
+		}
+		virtual void Fail(System::Exception^ exception) override {
+			Source->TrySetException(exception);
+		}
+	};
+
+	ref class WriteOperation : AsyncOperation {
+	public:
+		WriteOperation(System::String^ apiName, bool notFoundIsResult) : AsyncOperation(apiName),
+			notFoundIsResult_(notFoundIsResult),
+			Source(gcnew System::Threading::Tasks::TaskCompletionSource<bool>()) {
+		}
+		System::Threading::Tasks::TaskCompletionSource<bool>^ Source;
+		virtual void Complete() override {
+			if (Result == 0)
+				Source->TrySetResult(true);
+			else if (Result == WT_NOTFOUND && notFoundIsResult_)
+				Source->TrySetResult(false);
+			else
+				Source->TrySetException(Error());
+		}
+		virtual void Fail(System::Exception^ exception) override {
+			Source->TrySetException(exception);
+		}
+	private:
+		bool notFoundIsResult_;
+	};
+
+	// Owns a native completion queue and a thread draining it. Operations travel through native
+	// code as GCHandle tokens, so native threads never call into managed code.
+	ref class CompletionDispatcher {
+	public:
+		CompletionDispatcher(System::String^ threadName) {
+			queue_ = new NativeCompletionQueue();
+			thread_ = gcnew System::Threading::Thread(gcnew System::Threading::ThreadStart(this, &CompletionDispatcher::Run));
+			thread_->IsBackground = true;
+			thread_->Name = threadName;
+			thread_->Start();
+		}
+
+		property NativeCompletionQueue* Queue {
+			NativeCompletionQueue* get() { return queue_; }
+		}
+
+		static __int64 Register(AsyncOperation^ operation) {
+			System::Runtime::InteropServices::GCHandle handle = System::Runtime::InteropServices::GCHandle::Alloc(operation);
+			return System::Runtime::InteropServices::GCHandle::ToIntPtr(handle).ToInt64();
+		}
+
+		// For operations that were registered but never reached native code
+		static void Cancel(__int64 token, System::Exception^ exception) {
+			Take(token)->Fail(exception);
+		}
+
+		// Producers posting to the queue must be stopped before
+		void Shutdown() {
+			if (queue_ == nullptr)
+				return;
+			queue_->Shutdown();
+			thread_->Join();
+			delete queue_;
+			queue_ = nullptr;
+		}
+
+	private:
+		NativeCompletionQueue* queue_;
+		System::Threading::Thread^ thread_;
+
+		static AsyncOperation^ Take(__int64 token) {
+			System::Runtime::InteropServices::GCHandle handle =
+				System::Runtime::InteropServices::GCHandle::FromIntPtr(System::IntPtr(token));
+			AsyncOperation^ operation = (AsyncOperation^)handle.Target;
+			handle.Free();
+			return operation;
+		}
+
+		void Run() {
+			std::vector<NativeCompletion> completions;
+			while (queue_->Drain(completions, asyncDispatchBatch)) {
+				array<AsyncOperation^>^ batch = gcnew array<AsyncOperation^>((int)completions.size());
+				for (size_t i = 0; i < completions.size(); i++) {
+					const NativeCompletion& completion = completions[i];
+					AsyncOperation^ operation = Take(completion.token);
+					operation->Result = completion.result;
+					if (!completion.value.empty())
+						operation->Value = to_array(completion.value.data(), (int)completion.value.size());
+					batch[i] = operation;
+				}
+				completions.clear();
+				// continuations of completed tasks run inline, keep them off the dispatcher thread
+				System::Threading::ThreadPool::UnsafeQueueUserWorkItem(
+					gcnew System::Threading::WaitCallback(&CompletionDispatcher::CompleteBatch), batch);
+			}
+		}
+
+		static void CompleteBatch(System::Object^ state) {
+			array<AsyncOperation^>^ batch = (array<AsyncOperation^>^)state;
+			for (int i = 0; i < batch->Length; i++)
+				batch[i]->Complete();
+		}
+	};
+
+	ref class AsyncDispatcher {
+	public:
+		AsyncDispatcher(WT_CONNECTION* connection) : completions_(gcnew CompletionDispatcher("WiredTigerNet async dispatcher")) {
+			executor_ = new NativeAsyncExecutor(connection, completions_->Queue);
+		}
+
+		void Submit(NativeAsyncOpType type, System::String^ uri, System::String^ config, array<Byte>^ key, array<Byte>^ value,
+			AsyncOperation^ operation) {
+			std::string uriStr(str_or_die(uri, "uri"));
+			std::string configStr(str_or_empty(config));
+			if (key == nullptr)
+				throw gcnew System::ArgumentNullException("key");
+			if ((type == NativeAsyncInsert || type == NativeAsyncUpdate) && value == nullptr)
+				throw gcnew System::ArgumentNullException("value");
+			if (!executor_->HasItemFormats(uriStr.c_str()))
+				throw gcnew System::ArgumentException("async operations need key_format=u and value_format=u", "uri");
+			PIN_OR_NULL(keyPtr, Byte, key)
+			PIN_OR_NULL(valuePtr, Byte, value)
+			__int64 token = CompletionDispatcher::Register(operation);
+			try {
+				executor_->Submit(type, uriStr.c_str(), configStr.c_str(), token,
+					keyPtr, key->Length, valuePtr, value == nullptr ? 0 : value->Length);
+			}
+			catch (const NativeWiredTigerApiException& e) {
+				CompletionDispatcher::Cancel(token, gcnew WiredTigerApiException(e.ErrorCode(), gcnew System::String(e.ApiName().c_str())));
+			}
+		}
+
+		void Flush() {
+			INVOKE_NATIVE(executor_->Flush())
+		}
+
+		void Shutdown() {
+			if (executor_ == nullptr)
+				return;
+			delete executor_;
+			executor_ = nullptr;
+			completions_->Shutdown();
+		}
+
+	private:
+		CompletionDispatcher^ completions_;
+		NativeAsyncExecutor* executor_;
+	};
+
+	// Delivers events buffered by a native ring to the handler on its own thread,
+	// so WiredTiger threads only copy messages and never wait for managed code
+	ref class EventDrainer {
+	public:
+		EventDrainer(IEventHandler^ eventHandler, int capacity) : eventHandler_(eventHandler), deliver_(true) {
+			progressHandler_ = dynamic_cast<IProgressHandler^>(eventHandler);
+			ring_ = new NativeEventRing(capacity, progressHandler_ == nullptr ? -1 : progressReportIntervalMilliseconds);
+			thread_ = gcnew System::Threading::Thread(gcnew System::Threading::ThreadStart(this, &EventDrainer::Run));
+			thread_->IsBackground = true;
+			thread_->Name = "WiredTigerNet event drainer";
+			thread_->Start();
+		}
+
+		property WT_EVENT_HANDLER* Handler {
+			WT_EVENT_HANDLER* get() { return ring_->Handler(); }
+		}
+		property __int64 DroppedErrors {
+			__int64 get() { return ring_ == nullptr ? droppedErrors_ : ring_->DroppedErrors(); }
+		}
+		property __int64 DroppedMessages {
+			__int64 get() { return ring_ == nullptr ? droppedMessages_ : ring_->DroppedMessages(); }
+		}
+		property __int64 DroppedProgress {
+			__int64 get() { return ring_ == nullptr ? droppedProgress_ : ring_->DroppedProgress(); }
+		}
+
+		// Delivers the remaining events unless deliver is false, the connection must be closed before
+		void Shutdown(bool deliver) {
+			if (ring_ == nullptr)
+				return;
+			deliver_ = deliver;
+			ring_->Shutdown();
+			thread_->Join();
+			droppedErrors_ = ring_->DroppedErrors();
+			droppedMessages_ = ring_->DroppedMessages();
+			droppedProgress_ = ring_->DroppedProgress();
+			delete ring_;
+			ring_ = nullptr;
+		}
+
+	private:
+		IEventHandler^ eventHandler_;
+		IProgressHandler^ progressHandler_;
+		NativeEventRing* ring_;
+		System::Threading::Thread^ thread_;
+		volatile bool deliver_;
+		__int64 droppedErrors_;
+		__int64 droppedMessages_;
+		__int64 droppedProgress_;
+
+		void Run() {
+			std::vector<NativeEvent> events;
+			while (ring_->Drain(events, eventDrainBatch)) {
+				for (size_t i = 0; i < events.size() && deliver_; i++)
+					Deliver(events[i]);
+				events.clear();
+			}
+		}
+
+		void Deliver(const NativeEvent& event) {
+			try {
+				System::String^ message = gcnew System::String(event.message.c_str(), 0, (int)event.message.size());
+				if (event.type == NativeEventError)
+					eventHandler_->OnError(event.errorCode, gcnew System::String(wiredtiger_strerror(event.errorCode)), message);
+				else if (event.type == NativeEventMessage)
+					eventHandler_->OnMessage(message);
+				else
+					progressHandler_->OnProgress(message, (__int64)event.progress);
+			}
+			catch (System::Exception^) {
+				//a failing handler must not stop delivery of the next events
+			}
+		}
+	};
+}
+
+// *************
+// LatencyHistogram
+// *************
+
+LatencyHistogram::LatencyHistogram(System::String^ table, LatencyOperation operation, __int64 count,
+	__int64 totalNanoseconds, __int64 maxNanoseconds, array<__int64>^ buckets)
+	: table_(table),
+	operation_(operation),
+	count_(count),
+	totalNanoseconds_(totalNanoseconds),
+	maxNanoseconds_(maxNanoseconds),
+	buckets_(buckets) {
+}
+
+__int64 LatencyHistogram::GetPercentile(double percentile) {
+	if (percentile < 0 || percentile > 100)
+		throw gcnew System::ArgumentOutOfRangeException("percentile", "percentile must be between 0 and 100");
+	if (count_ == 0)
+		return 0;
+	__int64 target = (__int64)System::Math::Ceiling(count_ * percentile / 100);
+	if (target < 1)
+		target = 1;
+	__int64 seen = 0;
+	for (int i = 0; i < buckets_->Length; i++) {
+		seen += buckets_[i];
+		if (seen >= target)
+			return System::Math::Min(LatencyBucketUpperBound(i), maxNanoseconds_);
+	}
+	return maxNanoseconds_;
+}
+
+// *************
+// Connection
+// *************
+Connection::Connection(System::String^ closeConfig, IEventHandler^ eventHandler, int eventBufferCapacity)
+	:eventHandler_(eventHandler),
+	closeConfig_(closeConfig),
+	writeBatchers_(gcnew System::Collections::Generic::List<WriteBatcher^>()),
+	parallelScans_(gcnew System::Collections::Generic::List<ParallelScan^>()),
+	statisticsSession_(nullptr),
+	statisticsLock_(gcnew System::Object()),
+	onErrorDelegate_(gcnew OnErrorDelegate(this, &Connection::OnError)),
 	onMessageDelegate_(gcnew OnMessageDelegate(this, &Connection::OnMessage)),
+	onProgressDelegate_(gcnew OnProgressDelegate(this, &Connection::OnProgress)),
 	WiredTigerComponent(nullptr) {
 	if (eventHandler_ == nullptr)
 		nativeEventHandler_ = nullptr;
+	else if (eventBufferCapacity > 0) {
+		eventDrainer_ = gcnew EventDrainer(eventHandler_, eventBufferCapacity);
+		nativeEventHandler_ = eventDrainer_->Handler;
+	}
 	else {
-		typedef int(*handle_error_t)(WT_EVENT_HANDLER *handler, WT_SESSION *session, int error, const char *message);
-		typedef int(*handle_message_t)(WT_EVENT_HANDLER *handler, WT_SESSION *session, const char *message);
-		nativeEventHandler_ = new WT_EVENT_HANDLER{
-			to_pointer<handle_error_t>(onErrorDelegate_),
-			to_pointer<handle_message_t>(onMessageDelegate_),
-			nullptr,
-			nullptr };
+		NativeProgressCallback progress = dynamic_cast<IProgressHandler^>(eventHandler_) == nullptr
+			? nullptr
+			: to_pointer<NativeProgressCallback>(onProgressDelegate_);
+		directEventHandler_ = new NativeEventHandler(
+			to_pointer<NativeErrorCallback>(onErrorDelegate_),
+			to_pointer<NativeMessageCallback>(onMessageDelegate_),
+			progress,
+			progressReportIntervalMilliseconds);
+		nativeEventHandler_ = directEventHandler_->Handler();
 	}
 }
 
 void Connection::Close() {
+	//writer threads use sessions of this connection, so they are stopped first
+	if (can_use_referenced_objects()) {
+		for each (WriteBatcher^ batcher in writeBatchers_)
+			delete batcher;
+		writeBatchers_->Clear();
+		//scan threads use sessions of this connection too, disposing a scan removes it from the list
+		array<ParallelScan^>^ scans;
+		System::Threading::Monitor::Enter(parallelScans_);
+		try {
+			scans = parallelScans_->ToArray();
+		}
+		finally {
+			System::Threading::Monitor::Exit(parallelScans_);
+		}
+		for each (ParallelScan^ scan in scans)
+			delete scan;
+	}
+	if (asyncDispatcher_ != nullptr) {
+		asyncDispatcher_->Shutdown();
+		asyncDispatcher_ = nullptr;
+	}
+	//closing the connection closes the statistics session
+	statisticsSession_ = nullptr;
 	if (connection_ != nullptr)
 	{
 		std::string configStr(str_or_empty(closeConfig_));
 		connection_->close(connection_, configStr.c_str());
 		connection_ = nullptr;
 	}
-	if (nativeEventHandler_ != nullptr) {
-		delete nativeEventHandler_;
-		nativeEventHandler_ = nullptr;
+	if (eventDrainer_ != nullptr) {
+		//the connection is closed, so the ring gets no more events and the handler it owns can go
+		eventDrainer_->Shutdown(can_use_referenced_objects());
+	}
+	if (directEventHandler_ != nullptr) {
+		delete directEventHandler_;
+		directEventHandler_ = nullptr;
 	}
+	nativeEventHandler_ = nullptr;
 }
 
 Session^ Connection::OpenSession() {
@@ -573,6 +1865,229 @@ Session^ Connection::OpenSession() {
 	return gcnew Session(session, this);
 }
 
+SessionPool^ Connection::CreateSessionPool(int maxSize) {
+	return CreateSessionPool(maxSize, System::Threading::Timeout::InfiniteTimeSpan);
+}
+
+SessionPool^ Connection::CreateSessionPool(int maxSize, System::TimeSpan idleTimeout) {
+	if (maxSize <= 0)
+		throw gcnew System::ArgumentOutOfRangeException("maxSize", "maxSize must be positive");
+	return gcnew SessionPool(this, maxSize, idleTimeout);
+}
+
+AsyncDispatcher^ Connection::GetAsyncDispatcher() {
+	AsyncDispatcher^ dispatcher = asyncDispatcher_;
+	if (dispatcher != nullptr)
+		return dispatcher;
+	System::Threading::Monitor::Enter(this);
+	try {
+		if (IsDisposed())
+			throw gcnew System::ObjectDisposedException("Connection");
+		if (asyncDispatcher_ == nullptr)
+			asyncDispatcher_ = gcnew AsyncDispatcher(connection_);
+		return asyncDispatcher_;
+	}
+	finally {
+		System::Threading::Monitor::Exit(this);
+	}
+}
+
+System::Threading::Tasks::Task<array<Byte>^>^ Connection::SearchAsync(System::String^ uri, array<Byte>^ key) {
+	SearchOperation^ operation = gcnew SearchOperation("async_op->search, " + uri);
+	GetAsyncDispatcher()->Submit(NativeAsyncSearch, uri, nullptr, key, nullptr, operation);
+	return operation->Source->Task;
+}
+
+System::Threading::Tasks::Task^ Connection::InsertAsync(System::String^ uri, array<Byte>^ key, array<Byte>^ value) {
+	return InsertAsync(uri, nullptr, key, value);
+}
+
+System::Threading::Tasks::Task^ Connection::InsertAsync(System::String^ uri, System::String^ config, array<Byte>^ key, array<Byte>^ value) {
+	WriteOperation^ operation = gcnew WriteOperation("async_op->insert, " + uri, false);
+	GetAsyncDispatcher()->Submit(NativeAsyncInsert, uri, config, key, value, operation);
+	return operation->Source->Task;
+}
+
+System::Threading::Tasks::Task^ Connection::UpdateAsync(System::String^ uri, array<Byte>^ key, array<Byte>^ value) {
+	WriteOperation^ operation = gcnew WriteOperation("async_op->update, " + uri, false);
+	GetAsyncDispatcher()->Submit(NativeAsyncUpdate, uri, nullptr, key, value, operation);
+	return operation->Source->Task;
+}
+
+System::Threading::Tasks::Task<bool>^ Connection::RemoveAsync(System::String^ uri, array<Byte>^ key) {
+	WriteOperation^ operation = gcnew WriteOperation("async_op->remove, " + uri, true);
+	//with the default overwrite=true remove succeeds for missing keys
+	GetAsyncDispatcher()->Submit(NativeAsyncRemove, uri, "overwrite=false", key, nullptr, operation);
+	return operation->Source->Task;
+}
+
+void Connection::AsyncFlush() {
+	AsyncDispatcher^ dispatcher = asyncDispatcher_;
+	if (dispatcher != nullptr)
+		dispatcher->Flush();
+}
+
+WriteBatcher^ Connection::CreateWriteBatcher(int writers) {
+	return CreateWriteBatcher(writers, 256, System::TimeSpan::Zero, nullptr);
+}
+
+WriteBatcher^ Connection::CreateWriteBatcher(int writers, int maxBatchSize, System::TimeSpan maxDelay, CommitOptions^ commitOptions) {
+	if (writers <= 0)
+		throw gcnew System::ArgumentOutOfRangeException("writers", "writers must be positive");
+	if (maxBatchSize <= 0)
+		throw gcnew System::ArgumentOutOfRangeException("maxBatchSize", "maxBatchSize must be positive");
+	if (maxDelay < System::TimeSpan::Zero)
+		throw gcnew System::ArgumentOutOfRangeException("maxDelay", "maxDelay can't be negative");
+	int maxDelayMicroseconds = (int)System::Math::Min(maxDelay.Ticks / 10, (__int64)System::Int32::MaxValue);
+	std::string commitConfig(copy_config(commitOptions));
+	CompletionDispatcher^ completions = gcnew CompletionDispatcher("WiredTigerNet write batcher dispatcher");
+	NativeWriteBatcher* batcher;
+	try {
+		INVOKE_NATIVE(batcher = new NativeWriteBatcher(connection_, writers, maxBatchSize, maxDelayMicroseconds, config_or_null(commitConfig), completions->Queue))
+	}
+	catch (...) {
+		completions->Shutdown();
+		throw;
+	}
+	WriteBatcher^ writeBatcher = gcnew WriteBatcher(batcher, completions, this);
+	System::Threading::Monitor::Enter(writeBatchers_);
+	try {
+		writeBatchers_->Add(writeBatcher);
+	}
+	finally {
+		System::Threading::Monitor::Exit(writeBatchers_);
+	}
+	return writeBatcher;
+}
+
+// batches of 1024 rows each scan thread may read ahead of the consumer
+static const int parallelScanQueuedBatches = 4;
+
+__int64 Connection::ParallelCount(System::String^ uri, Range range, int threads) {
+	if (threads <= 0)
+		throw gcnew System::ArgumentOutOfRangeException("threads", "threads must be positive");
+	std::string uriStr(str_or_die(uri, "uri"));
+	NativeRange nativeRange = to_native_range(range);
+	INVOKE_NATIVE(return ::ParallelCount(connection_, uriStr.c_str(), nullptr, nativeRange, threads))
+}
+
+ParallelScan^ Connection::OpenParallelScan(System::String^ uri, Range range, int threads, bool ordered) {
+	if (threads <= 0)
+		throw gcnew System::ArgumentOutOfRangeException("threads", "threads must be positive");
+	std::string uriStr(str_or_die(uri, "uri"));
+	NativeRange nativeRange = to_native_range(range);
+	NativeParallelScan* nativeScan;
+	INVOKE_NATIVE(nativeScan = new NativeParallelScan(connection_, uriStr.c_str(), nullptr, nativeRange, threads, ordered, parallelScanQueuedBatches))
+	ParallelScan^ scan;
+	try {
+		scan = gcnew ParallelScan(nativeScan, this);
+	}
+	catch (...) {
+		delete nativeScan;
+		throw;
+	}
+	System::Threading::Monitor::Enter(parallelScans_);
+	try {
+		parallelScans_->Add(scan);
+	}
+	finally {
+		System::Threading::Monitor::Exit(parallelScans_);
+	}
+	return scan;
+}
+
+void Connection::RemoveParallelScan(ParallelScan^ scan) {
+	System::Threading::Monitor::Enter(parallelScans_);
+	try {
+		parallelScans_->Remove(scan);
+	}
+	finally {
+		System::Threading::Monitor::Exit(parallelScans_);
+	}
+}
+
+static const int connectionStatisticsKeys[] = {
+	WT_STAT_CONN_CACHE_BYTES_INUSE,
+	WT_STAT_CONN_CACHE_BYTES_MAX,
+	WT_STAT_CONN_CACHE_BYTES_DIRTY,
+	WT_STAT_CONN_CACHE_EVICTION_CLEAN,
+	WT_STAT_CONN_CACHE_EVICTION_DIRTY,
+	WT_STAT_CONN_CACHE_EVICTION_FAIL,
+	WT_STAT_CONN_TXN_CHECKPOINT,
+	WT_STAT_CONN_TXN_CHECKPOINT_TIME_RECENT,
+	WT_STAT_CONN_TXN_CHECKPOINT_TIME_TOTAL,
+	WT_STAT_CONN_TXN_COMMIT,
+	WT_STAT_CONN_TXN_ROLLBACK
+};
+
+ConnectionStatistics Connection::GetStatistics(bool fast) {
+	const int count = sizeof(connectionStatisticsKeys) / sizeof(connectionStatisticsKeys[0]);
+	__int64 values[count];
+	System::Threading::Monitor::Enter(statisticsLock_);
+	try {
+		if (IsDisposed())
+			throw gcnew System::ObjectDisposedException("Connection");
+		if (statisticsSession_ == nullptr) {
+			WT_SESSION* session;
+			int r = connection_->open_session(connection_, nullptr, nullptr, &session);
+			if (r != 0)
+				throw gcnew WiredTigerApiException(r, "connection->open_session");
+			statisticsSession_ = session;
+		}
+		INVOKE_NATIVE(ReadStatistics(statisticsSession_, "", fast ? "statistics=(fast)" : nullptr, connectionStatisticsKeys, count, values))
+	}
+	finally {
+		System::Threading::Monitor::Exit(statisticsLock_);
+	}
+	ConnectionStatistics result;
+	result.CacheBytesInUse = values[0];
+	result.CacheBytesMax = values[1];
+	result.CacheBytesDirty = values[2];
+	result.PagesEvictedClean = values[3];
+	result.PagesEvictedDirty = values[4];
+	result.EvictionFailures = values[5];
+	result.Checkpoints = values[6];
+	result.CheckpointTimeRecent = values[7];
+	result.CheckpointTimeTotal = values[8];
+	result.TransactionsCommitted = values[9];
+	result.TransactionsRolledBack = values[10];
+	return result;
+}
+
+bool Connection::LatencyTracking::get() {
+	return IsLatencyTracking();
+}
+
+void Connection::LatencyTracking::set(bool value) {
+	SetLatencyTracking(value);
+}
+
+array<LatencyHistogram^>^ Connection::GetLatencySnapshot() {
+	std::vector<NativeLatencySnapshot> snapshots;
+	SnapshotLatency(snapshots);
+	array<LatencyHistogram^>^ result = gcnew array<LatencyHistogram^>((int)snapshots.size());
+	for (size_t i = 0; i < snapshots.size(); i++) {
+		const NativeLatencySnapshot& snapshot = snapshots[i];
+		array<__int64>^ buckets = gcnew array<__int64>(latencyBucketCount);
+		System::Runtime::InteropServices::Marshal::Copy(System::IntPtr((void*)snapshot.buckets.data()), buckets, 0, latencyBucketCount);
+		result[i] = gcnew LatencyHistogram(gcnew System::String(snapshot.table.c_str()), (LatencyOperation)snapshot.op,
+			snapshot.count, snapshot.totalNanoseconds, snapshot.maxNanoseconds, buckets);
+	}
+	return result;
+}
+
+__int64 Connection::DroppedErrors::get() {
+	return eventDrainer_ == nullptr ? 0 : eventDrainer_->DroppedErrors;
+}
+
+__int64 Connection::DroppedMessages::get() {
+	return eventDrainer_ == nullptr ? 0 : eventDrainer_->DroppedMessages;
+}
+
+__int64 Connection::DroppedProgress::get() {
+	return eventDrainer_ == nullptr ? 0 : eventDrainer_->DroppedProgress;
+}
+
 System::String^ Connection::GetHome() {
 	const char *home = connection_->get_home(connection_);
 	return gcnew System::String(home);
@@ -584,23 +2099,28 @@ Connection^ Connection::Open(System::String^ home, System::String^ config, IEven
 
 Connection^ Connection::Open(System::String^ home, System::String^ config, System::String^ closeConfig, IEventHandler^ eventHandler)
 {
+	return Open(home, config, closeConfig, eventHandler, 0);
+}
+
+Connection^ Connection::Open(System::String^ home, System::String^ config, System::String^ closeConfig, IEventHandler^ eventHandler,
+	int eventBufferCapacity)
+{
+	if (eventBufferCapacity < 0)
+		throw gcnew System::ArgumentOutOfRangeException("eventBufferCapacity", "eventBufferCapacity must not be negative");
 	WT_CONNECTION *connectionp;
 	std::string homeStr(str_or_die(home, "home"));
 	std::string configStr(str_or_empty(config));
-	Connection^ ret = gcnew Connection(closeConfig, eventHandler);
+	Connection^ ret = gcnew Connection(closeConfig, eventHandler, eventBufferCapacity);
 	int r = wiredtiger_open(homeStr.c_str(), ret->nativeEventHandler_, configStr.c_str(), &connectionp);
-	if (r != 0)
+	if (r != 0) {
+		//delivers buffered events before the exception
+		delete ret;
 		throw gcnew WiredTigerApiException(r, "wiredtiger_open");
+	}
 	ret->connection_ = connectionp;
 	return ret;
 }
 
-static bool can_use_referenced_objects() {
-	bool isFinalizingForUnload = System::AppDomain::CurrentDomain->IsFinalizingForUnload();
-	bool hasShutdownStarted = System::Environment::HasShutdownStarted;
-	return !isFinalizingForUnload && !hasShutdownStarted;
-}
-
 int Connection::OnError(WT_EVENT_HANDLER *, WT_SESSION *, int error, const char* message) {
 	if (!can_use_referenced_objects())
 		return -2;
@@ -626,4 +2146,310 @@ int Connection::OnMessage(WT_EVENT_HANDLER *, WT_SESSION *, const char* message)
 		//do not propagate managed exceptions as it can violate internal wt invariants
 		return -1;
 	}
-}
\ No newline at end of file
+}
+
+int Connection::OnProgress(const char* operation, unsigned __int64 progress) {
+	if (!can_use_referenced_objects())
+		return -2;
+	try {
+		((IProgressHandler^)eventHandler_)->OnProgress(gcnew System::String(operation), (__int64)progress);
+		return 0;
+	}
+	catch (...) {
+		//do not propagate managed exceptions as it can violate internal wt invariants
+		return -1;
+	}
+}
+
+// *************
+// SessionPool
+// *************
+
+PooledSession::PooledSession(SessionPool^ pool, WiredTigerNet::Session^ session) : pool_(pool), session_(session) {
+}
+
+PooledSession::~PooledSession() {
+	if (session_ == nullptr)
+		return;
+	WiredTigerNet::Session^ session = session_;
+	session_ = nullptr;
+	pool_->Return(session);
+	System::GC::SuppressFinalize(this);
+}
+
+PooledSession::!PooledSession() {
+	//session finalizer closes the native handle, the pool only frees the slot
+	if (session_ != nullptr && can_use_referenced_objects())
+		pool_->Leaked();
+}
+
+WiredTigerNet::Session^ PooledSession::Session::get() {
+	if (session_ == nullptr)
+		throw gcnew System::ObjectDisposedException("PooledSession");
+	return session_;
+}
+
+SessionPool::SessionPool(Connection^ connection, int maxSize, System::TimeSpan idleTimeout)
+	: connection_(connection),
+	maxSize_(maxSize),
+	idleTimeout_(idleTimeout),
+	idle_(gcnew System::Collections::Generic::List<IdleSession^>()),
+	lock_(gcnew System::Object()),
+	openCount_(0),
+	leakedCount_(0),
+	closed_(false),
+	WiredTigerComponent(connection) {
+}
+
+int SessionPool::IdleCount::get() {
+	System::Threading::Monitor::Enter(lock_);
+	try {
+		return idle_->Count;
+	}
+	finally {
+		System::Threading::Monitor::Exit(lock_);
+	}
+}
+
+PooledSession^ SessionPool::Rent() {
+	return Rent(System::Threading::Timeout::InfiniteTimeSpan);
+}
+
+PooledSession^ SessionPool::Rent(System::TimeSpan timeout) {
+	int threadId = System::Threading::Thread::CurrentThread->ManagedThreadId;
+	System::Diagnostics::Stopwatch^ stopwatch = System::Diagnostics::Stopwatch::StartNew();
+	System::Threading::Monitor::Enter(lock_);
+	try {
+		while (true) {
+			if (closed_ || IsDisposed())
+				throw gcnew System::ObjectDisposedException("SessionPool");
+			if (idle_->Count > 0) {
+				int index = idle_->Count - 1;
+				for (int i = idle_->Count - 1; i >= 0; i--)
+					if (idle_[i]->threadId == threadId) {
+						index = i;
+						break;
+					}
+				Session^ session = idle_[index]->session;
+				idle_->RemoveAt(index);
+				return gcnew PooledSession(this, session);
+			}
+			if (openCount_ < maxSize_) {
+				openCount_++;
+				break;
+			}
+			int waitMilliseconds = System::Threading::Timeout::Infinite;
+			if (timeout != System::Threading::Timeout::InfiniteTimeSpan) {
+				__int64 remaining = (__int64)timeout.TotalMilliseconds - stopwatch->ElapsedMilliseconds;
+				if (remaining <= 0)
+					throw gcnew System::TimeoutException("no session became available in the pool within " + timeout.ToString());
+				waitMilliseconds = (int)remaining;
+			}
+			System::Threading::Monitor::Wait(lock_, waitMilliseconds);
+		}
+	}
+	finally {
+		System::Threading::Monitor::Exit(lock_);
+	}
+	try {
+		return gcnew PooledSession(this, connection_->OpenSession());
+	}
+	catch (...) {
+		System::Threading::Monitor::Enter(lock_);
+		openCount_--;
+		System::Threading::Monitor::Pulse(lock_);
+		System::Threading::Monitor::Exit(lock_);
+		throw;
+	}
+}
+
+void SessionPool::CollectExpired(System::TimeSpan idleTime, System::Collections::Generic::List<Session^>^ expired) {
+	__int64 now = System::Diagnostics::Stopwatch::GetTimestamp();
+	__int64 maxIdleTicks = (__int64)(idleTime.TotalSeconds * System::Diagnostics::Stopwatch::Frequency);
+	//idle_ is ordered by return time, so expired sessions are at the front
+	while (idle_->Count > 0 && now - idle_[0]->returnedAt > maxIdleTicks) {
+		expired->Add(idle_[0]->session);
+		idle_->RemoveAt(0);
+		openCount_--;
+	}
+}
+
+void SessionPool::Return(Session^ session) {
+	System::Collections::Generic::List<Session^>^ expired = gcnew System::Collections::Generic::List<Session^>();
+	//state of the renter must not leak to the next one
+	bool reusable = session->ResetForPool();
+	System::Threading::Monitor::Enter(lock_);
+	try {
+		if (!reusable || closed_ || IsDisposed()) {
+			openCount_--;
+			expired->Add(session);
+			System::Threading::Monitor::Pulse(lock_);
+		}
+		else {
+			IdleSession^ entry = gcnew IdleSession();
+			entry->session = session;
+			entry->threadId = System::Threading::Thread::CurrentThread->ManagedThreadId;
+			entry->returnedAt = System::Diagnostics::Stopwatch::GetTimestamp();
+			idle_->Add(entry);
+			if (idleTimeout_ != System::Threading::Timeout::InfiniteTimeSpan)
+				CollectExpired(idleTimeout_, expired);
+			System::Threading::Monitor::Pulse(lock_);
+		}
+	}
+	finally {
+		System::Threading::Monitor::Exit(lock_);
+	}
+	for each (Session^ s in expired)
+		delete s;
+}
+
+void SessionPool::Leaked() {
+	System::Threading::Monitor::Enter(lock_);
+	try {
+		openCount_--;
+		leakedCount_++;
+		System::Threading::Monitor::Pulse(lock_);
+	}
+	finally {
+		System::Threading::Monitor::Exit(lock_);
+	}
+}
+
+int SessionPool::Trim(System::TimeSpan idleTime) {
+	System::Collections::Generic::List<Session^>^ expired = gcnew System::Collections::Generic::List<Session^>();
+	System::Threading::Monitor::Enter(lock_);
+	try {
+		CollectExpired(idleTime, expired);
+	}
+	finally {
+		System::Threading::Monitor::Exit(lock_);
+	}
+	for each (Session^ s in expired)
+		delete s;
+	return expired->Count;
+}
+
+void SessionPool::Close() {
+	System::Collections::Generic::List<Session^>^ sessions = gcnew System::Collections::Generic::List<Session^>();
+	System::Threading::Monitor::Enter(lock_);
+	try {
+		closed_ = true;
+		for each (IdleSession^ entry in idle_)
+			sessions->Add(entry->session);
+		openCount_ -= idle_->Count;
+		idle_->Clear();
+		System::Threading::Monitor::PulseAll(lock_);
+	}
+	finally {
+		System::Threading::Monitor::Exit(lock_);
+	}
+	for each (Session^ s in sessions)
+		delete s;
+}
+
+// *************
+// WriteBatcher
+// *************
+
+WriteBatcher::WriteBatcher(NativeWriteBatcher* batcher, CompletionDispatcher^ completions, WiredTigerComponent^ connection)
+	: batcher_(batcher),
+	completions_(completions),
+	closeLock_(gcnew System::Threading::ReaderWriterLockSlim()),
+	WiredTigerComponent(connection) {
+}
+
+void WriteBatcher::Enqueue(NativeWriteOpType type, System::String^ uri, array<Byte>^ key, array<Byte>^ value, AsyncOperation^ operation) {
+	std::string uriStr(str_or_die(uri, "uri"));
+	if (key == nullptr)
+		throw gcnew System::ArgumentNullException("key");
+	PIN_OR_NULL(keyPtr, Byte, key)
+	PIN_OR_NULL(valuePtr, Byte, value)
+	//producers share the read lock, Close takes the write lock to stop them before the writers
+	closeLock_->EnterReadLock();
+	try {
+		if (batcher_ == nullptr)
+			throw gcnew System::ObjectDisposedException("WriteBatcher");
+		__int64 token = CompletionDispatcher::Register(operation);
+		batcher_->Enqueue(type, uriStr.c_str(), token, keyPtr, key->Length, valuePtr, value == nullptr ? 0 : value->Length);
+	}
+	finally {
+		closeLock_->ExitReadLock();
+	}
+}
+
+System::Threading::Tasks::Task^ WriteBatcher::InsertAsync(System::String^ uri, array<Byte>^ key, array<Byte>^ value) {
+	if (value == nullptr)
+		throw gcnew System::ArgumentNullException("value");
+	WriteOperation^ operation = gcnew WriteOperation("write batcher insert, " + uri, false);
+	Enqueue(NativeWriteInsert, uri, key, value, operation);
+	return operation->Source->Task;
+}
+
+System::Threading::Tasks::Task^ WriteBatcher::InsertAsync(System::String^ uri, array<Byte>^ key) {
+	WriteOperation^ operation = gcnew WriteOperation("write batcher insert, " + uri, false);
+	Enqueue(NativeWriteInsert, uri, key, nullptr, operation);
+	return operation->Source->Task;
+}
+
+System::Threading::Tasks::Task<bool>^ WriteBatcher::RemoveAsync(System::String^ uri, array<Byte>^ key) {
+	WriteOperation^ operation = gcnew WriteOperation("write batcher remove, " + uri, true);
+	Enqueue(NativeWriteRemove, uri, key, nullptr, operation);
+	return operation->Source->Task;
+}
+
+__int64 WriteBatcher::Writes::get() {
+	NativeWriteBatcher* batcher = batcher_;
+	return batcher == nullptr ? 0 : batcher->Writes();
+}
+
+__int64 WriteBatcher::Transactions::get() {
+	NativeWriteBatcher* batcher = batcher_;
+	return batcher == nullptr ? 0 : batcher->Transactions();
+}
+
+void WriteBatcher::Close() {
+	if (!can_use_referenced_objects())
+		return;
+	closeLock_->EnterWriteLock();
+	NativeWriteBatcher* batcher = batcher_;
+	batcher_ = nullptr;
+	closeLock_->ExitWriteLock();
+	if (batcher == nullptr)
+		return;
+	delete batcher;
+	completions_->Shutdown();
+}
+
+// *************
+// ParallelScan
+// *************
+
+ParallelScan::ParallelScan(NativeParallelScan* scan, Connection^ connection) : scan_(scan), connection_(connection), WiredTigerComponent(connection) {
+}
+
+int ParallelScan::ReadBatch(KeyValueBatch^ batch) {
+	if (IsDisposed())
+		throw gcnew System::ObjectDisposedException("ParallelScan");
+	int count;
+	int requiredSize;
+	while (true) {
+		pin_ptr<Byte> bufferPtr = &batch->buffer_[0];
+		pin_ptr<int> offsetsPtr = &batch->offsets_[0];
+		INVOKE_NATIVE(count = scan_->FetchBatch(bufferPtr, batch->buffer_->Length, offsetsPtr, batch->MaxRows, &requiredSize))
+		if (count > 0 || requiredSize == 0)
+			break;
+		batch->Grow(requiredSize);
+	}
+	batch->count_ = count;
+	return count;
+}
+
+void ParallelScan::Close() {
+	if (!can_use_referenced_objects())
+		return;
+	if (scan_ != nullptr) {
+		delete scan_;
+		scan_ = nullptr;
+	}
+	connection_->RemoveParallelScan(this);
+}
@@ -26,6 +26,13 @@ namespace WiredTigerNet {
 		void OnMessage(System::String^ message);
 	};
 
+	// An IEventHandler that also implements this interface gets progress of long operations such as
+	// verify, compact, checkpoint and recovery. WiredTiger reports an operation name and a counter,
+	// reports are throttled natively to one per operation and session per second.
+	public interface class IProgressHandler {
+		void OnProgress(System::String^ operation, __int64 progress);
+	};
+
 	public enum class ErrorCodes {
 		WtRollback = -31800,
 		WtDuplicateKey = -31801,
@@ -108,6 +115,35 @@ namespace WiredTigerNet {
 		static System::Nullable<Boundary> Inclusive(System::Nullable<Boundary> boundary);
 	};
 
+	// A sorted set of disjoint, non-touching ranges held natively as boundaries into one shared byte buffer.
+	// Set operations merge in one linear pass and return a new set, cursors iterate a set without normalizing
+	// it again. Sets are immutable, dispose them to free the native memory early.
+	public ref class RangeSet {
+	public:
+		RangeSet();
+		// Ranges may overlap and come in any order, empty ranges are dropped
+		RangeSet(System::Collections::Generic::IEnumerable<Range>^ ranges);
+		~RangeSet();
+		!RangeSet();
+		property int Count {
+			int get();
+		}
+		property Range default[int] {
+			Range get(int index);
+		}
+		bool Contains(array<Byte>^ key);
+		RangeSet^ Union(RangeSet^ other);
+		RangeSet^ Intersect(RangeSet^ other);
+		RangeSet^ Difference(RangeSet^ other);
+		RangeSet^ Complement();
+		array<Range>^ ToArray();
+	internal:
+		const NativeRangeSet& NativeSet();
+	private:
+		RangeSet(NativeRangeSet* set);
+		NativeRangeSet* set_;
+	};
+
 	public ref class WiredTigerComponent abstract  {
 	public:
 		WiredTigerComponent(WiredTigerComponent^ parent);
@@ -117,8 +153,11 @@ namespace WiredTigerNet {
 		virtual void Close() abstract;
 	internal:
 		bool IsDisposed();
+		// True while Close runs from the finalizer thread
+		bool IsFinalizing();
 	private:
 		bool disposed_;
+		bool finalizing_;
 		WiredTigerComponent^ parent_;
 	};
 
@@ -127,6 +166,65 @@ namespace WiredTigerNet {
 		Descending = 1,
 	};
 
+	public value class ByteView {
+	public:
+		property System::IntPtr Pointer {
+			System::IntPtr get() { return System::IntPtr((void*)data_); }
+		}
+		property int Length {
+			int get() { return length_; }
+		}
+		array<Byte>^ ToArray();
+		void CopyTo(array<Byte>^ target, int offset);
+		int CompareTo(array<Byte>^ other);
+		bool SequenceEqual(array<Byte>^ other);
+	internal:
+		ByteView(const Byte* data, int length);
+	private:
+		const Byte* data_;
+		int length_;
+	};
+
+	public ref class KeyValueBatch {
+	public:
+		KeyValueBatch(int maxRows);
+		KeyValueBatch(int maxRows, int initialBufferSize);
+		property int Count {
+			int get() { return count_; }
+		}
+		property int MaxRows {
+			int get() { return maxRows_; }
+		}
+		property array<Byte>^ Buffer {
+			array<Byte>^ get() { return buffer_; }
+		}
+		int KeyOffset(int index);
+		int KeyLength(int index);
+		int ValueOffset(int index);
+		int ValueLength(int index);
+		array<Byte>^ GetKey(int index);
+		array<Byte>^ GetValue(int index);
+	internal:
+		void Grow(int requiredSize);
+		array<Byte>^ buffer_;
+		array<int>^ offsets_;
+		int count_;
+	private:
+		int maxRows_;
+		void Init(int maxRows, int initialBufferSize);
+		void CheckIndex(int index);
+		array<Byte>^ Slice(int from, int to);
+	};
+
+	// Count of a range with its 95% confidence interval, Lower <= Estimate <= Upper.
+	// Exact counts have both bounds equal to Estimate.
+	public value struct CountEstimate {
+		__int64 Estimate;
+		__int64 Lower;
+		__int64 Upper;
+		bool IsExact;
+	};
+
 	public ref class Cursor : public WiredTigerComponent {
 	public:
 		void Insert(array<Byte>^ key, array<Byte>^ value);
@@ -134,15 +232,59 @@ namespace WiredTigerNet {
 		bool Next();
 		bool Prev();
 		void Remove(array<Byte>^ key);
+		// Try variants return the WiredTiger error code instead of throwing WiredTigerApiException
+		int TryInsert(array<Byte>^ key, array<Byte>^ value);
+		int TryInsert(array<Byte>^ key);
+		int TryRemove(array<Byte>^ key);
+		// Items are packed as keys[keyOffsets[i]..keyOffsets[i + 1]), so offsets hold one entry more than items.
+		// When statuses is null the first failure throws, otherwise every item gets its error code (0 on success)
+		// and the number of failed items is returned
+		int InsertBatch(array<Byte>^ keys, array<int>^ keyOffsets, array<Byte>^ values, array<int>^ valueOffsets, bool sort, array<int>^ statuses);
+		int InsertBatch(array<Byte>^ keys, array<int>^ keyOffsets, bool sort, array<int>^ statuses);
+		int RemoveBatch(array<Byte>^ keys, array<int>^ keyOffsets, bool sort, array<int>^ statuses);
+		// Entry i replaces sizes[i] bytes of the stored value at offsets[i] with data[i], returns false when key is not found.
+		// WiredTiger supports modify in snapshot isolation, so run it inside a transaction
+		bool Modify(array<Byte>^ key, array<int>^ offsets, array<int>^ sizes, array<array<Byte>^>^ data);
+		int TryModify(array<Byte>^ key, array<int>^ offsets, array<int>^ sizes, array<array<Byte>^>^ data);
+		// Key i gets entries [entryOffsets[i], entryOffsets[i + 1]), entry j data is packed as data[dataOffsets[j]..dataOffsets[j + 1])
+		int ModifyBatch(array<Byte>^ keys, array<int>^ keyOffsets, array<int>^ entryOffsets,
+			array<int>^ offsets, array<int>^ sizes, array<Byte>^ data, array<int>^ dataOffsets, bool sort, array<int>^ statuses);
 		void Reset();
 		bool Search(array<Byte>^ key);
 		bool SearchNear(array<Byte>^ key, [System::Runtime::InteropServices::OutAttribute] int% result);
+		bool TryGet(array<Byte>^ key, [System::Runtime::InteropServices::OutAttribute] array<Byte>^% value);
+		// Values are returned in the order of keys, null for keys that are not found
+		array<array<Byte>^>^ MultiGet(array<array<Byte>^>^ keys);
 		__int64 GetTotalCount(Range range);
 		__int64 GetTotalCount(Range range, __int64 maxCount);
+		__int64 GetTotalCount(RangeSet^ ranges);
+		__int64 GetTotalCount(RangeSet^ ranges, __int64 maxCount);
+		// Estimates the count of range within relative errorBudget, e.g. 0.05, by sampling random keys and scaling
+		// by the entries statistic of the table, which needs "all" or "tree_walk" database statistics. Without them,
+		// and for ranges too small to sample, the range is counted exactly. Leaves the cursor reset.
+		CountEstimate EstimateCount(Range range, double errorBudget);
+		// Scales samples by totalCount, the number of keys in the table known to the caller, instead of statistics
+		CountEstimate EstimateCount(Range range, double errorBudget, __int64 totalCount);
 		array<Byte>^ GetKey();
 		array<Byte>^ GetValue();
+		// Copy into buffer starting at offset and return the length, or return minus the required length
+		// without copying anything when the buffer is too small
+		int GetKey(array<Byte>^ buffer, int offset);
+		int GetValue(array<Byte>^ buffer, int offset);
+		// Views are not copied, they stay valid only until the next operation on this cursor
+		ByteView GetKeyView();
+		ByteView GetValueView();
 		bool IterationBegin(Range range, Direction direction);
+		// Iterates keys of any of ranges in one pass, in direction order and each key once. Ranges may overlap and
+		// come in any order. Moving past the end of a range continues to the next one without a new search
+		// when the next key already falls within it, so dense IN-lists cost about as much as a single scan.
+		bool IterationBegin(array<Range>^ ranges, Direction direction);
+		bool IterationBegin(RangeSet^ ranges, Direction direction);
 		bool IterationMove();
+		int ReadBatch(Range range, Direction direction, KeyValueBatch^ batch);
+		int ReadBatch(array<Range>^ ranges, Direction direction, KeyValueBatch^ batch);
+		int ReadBatch(RangeSet^ ranges, Direction direction, KeyValueBatch^ batch);
+		int ReadBatch(KeyValueBatch^ batch);
 		property CursorSchemaType SchemaType {
 			CursorSchemaType get() { return schemaType_; }
 		}
@@ -150,44 +292,331 @@ namespace WiredTigerNet {
 		virtual void Close() override;
 	internal:
 		Cursor(NativeCursor* cursor, WiredTigerComponent^ session);
+		NativeCursorCache* cache_;
 	private:
 		NativeCursor* cursor_;
 		CursorSchemaType schemaType_;
 	};
 
+	ref class Session;
+
+	// Closed with its session, the session must not be disposed while Add or Complete runs
+	public ref class BulkLoader : public WiredTigerComponent {
+	public:
+		// A null value is stored as an empty value
+		void Add(array<Byte>^ key, array<Byte>^ value);
+		void Add(array<Byte>^ key);
+		__int64 Complete();
+	protected:
+		virtual void Close() override;
+	internal:
+		BulkLoader(NativeBulkLoader* loader, Session^ session);
+	private:
+		NativeBulkLoader* loader_;
+		Session^ session_;
+	};
+
+	// Marshals the configuration string once and reuses it until a property changes
+	public ref class CachedConfig abstract {
+	public:
+		~CachedConfig();
+		!CachedConfig();
+	internal:
+		const char* NativeConfig();
+	protected:
+		CachedConfig();
+		void Invalidate();
+		virtual System::String^ Build() abstract;
+	private:
+		std::string* config_;
+	};
+
+	public enum class IsolationLevel {
+		ReadUncommitted,
+		ReadCommitted,
+		Snapshot
+	};
+
+	public enum class CommitSync {
+		On,
+		Off,
+		Background
+	};
+
+	public ref class TransactionOptions : public CachedConfig {
+	public:
+		property System::Nullable<IsolationLevel> Isolation {
+			System::Nullable<IsolationLevel> get() { return isolation_; }
+			void set(System::Nullable<IsolationLevel> value) { isolation_ = value; Invalidate(); }
+		}
+		property System::Nullable<bool> Sync {
+			System::Nullable<bool> get() { return sync_; }
+			void set(System::Nullable<bool> value) { sync_ = value; Invalidate(); }
+		}
+		property System::Nullable<int> Priority {
+			System::Nullable<int> get() { return priority_; }
+			void set(System::Nullable<int> value) { priority_ = value; Invalidate(); }
+		}
+		property System::Nullable<System::UInt64> ReadTimestamp {
+			System::Nullable<System::UInt64> get() { return readTimestamp_; }
+			void set(System::Nullable<System::UInt64> value) { readTimestamp_ = value; Invalidate(); }
+		}
+		property System::String^ Name {
+			System::String^ get() { return name_; }
+			void set(System::String^ value) { name_ = value; Invalidate(); }
+		}
+	protected:
+		virtual System::String^ Build() override;
+	private:
+		System::Nullable<IsolationLevel> isolation_;
+		System::Nullable<bool> sync_;
+		System::Nullable<int> priority_;
+		System::Nullable<System::UInt64> readTimestamp_;
+		System::String^ name_;
+	};
+
+	public ref class CommitOptions : public CachedConfig {
+	public:
+		property System::Nullable<CommitSync> Sync {
+			System::Nullable<CommitSync> get() { return sync_; }
+			void set(System::Nullable<CommitSync> value) { sync_ = value; Invalidate(); }
+		}
+		property System::Nullable<System::UInt64> CommitTimestamp {
+			System::Nullable<System::UInt64> get() { return commitTimestamp_; }
+			void set(System::Nullable<System::UInt64> value) { commitTimestamp_ = value; Invalidate(); }
+		}
+	protected:
+		virtual System::String^ Build() override;
+	private:
+		System::Nullable<CommitSync> sync_;
+		System::Nullable<System::UInt64> commitTimestamp_;
+	};
+
+	// Counters of a "statistics:" cursor. With fast only cheap in-memory statistics are read, otherwise the
+	// database statistics configuration applies. Checkpoint times are in milliseconds.
+	public value struct ConnectionStatistics {
+		__int64 CacheBytesInUse;
+		__int64 CacheBytesMax;
+		__int64 CacheBytesDirty;
+		__int64 PagesEvictedClean;
+		__int64 PagesEvictedDirty;
+		__int64 EvictionFailures;
+		__int64 Checkpoints;
+		__int64 CheckpointTimeRecent;
+		__int64 CheckpointTimeTotal;
+		__int64 TransactionsCommitted;
+		__int64 TransactionsRolledBack;
+	};
+
+	// Counters of a "statistics:<uri>" cursor. Entries and page counts walk the tree, they stay zero
+	// unless the database collects "all" or "tree_walk" statistics and fast is off.
+	public value struct TableStatistics {
+		__int64 FileSize;
+		__int64 CacheBytesInUse;
+		__int64 MaximumDepth;
+		__int64 Entries;
+		__int64 InternalPages;
+		__int64 LeafPages;
+		__int64 OverflowPages;
+	};
+
+	public enum class SplitBalance {
+		// about as many keys in every part
+		Rows,
+		// about as many key and value bytes in every part
+		Bytes
+	};
+
+	public enum class LatencyOperation {
+		Search,
+		SearchNear,
+		Next,
+		Prev,
+		Insert,
+		Remove,
+		Modify
+	};
+
+	// Latencies of one cursor operation on one table merged over all threads, in nanoseconds
+	public ref class LatencyHistogram {
+	public:
+		property System::String^ Table {
+			System::String^ get() { return table_; }
+		}
+		property LatencyOperation Operation {
+			LatencyOperation get() { return operation_; }
+		}
+		property __int64 Count {
+			__int64 get() { return count_; }
+		}
+		property __int64 TotalNanoseconds {
+			__int64 get() { return totalNanoseconds_; }
+		}
+		property __int64 MaxNanoseconds {
+			__int64 get() { return maxNanoseconds_; }
+		}
+		// Latency that percentile percent of operations do not exceed, e.g. GetPercentile(99.9).
+		// Buckets are about 6% wide, the result is the upper end of a bucket.
+		__int64 GetPercentile(double percentile);
+	internal:
+		LatencyHistogram(System::String^ table, LatencyOperation operation, __int64 count,
+			__int64 totalNanoseconds, __int64 maxNanoseconds, array<__int64>^ buckets);
+	private:
+		System::String^ table_;
+		LatencyOperation operation_;
+		__int64 count_;
+		__int64 totalNanoseconds_;
+		__int64 maxNanoseconds_;
+		array<__int64>^ buckets_;
+	};
+
+	ref class Session;
+
+	// Returns a WiredTiger error code, WtRollback makes RunTransaction retry the transaction.
+	// A thrown WiredTigerApiException counts as its error code.
+	public delegate int TransactionBody(Session^ session);
+
 	public ref class Session : public WiredTigerComponent {
 	public:
 		void BeginTran();
+		void BeginTran(TransactionOptions^ options);
 		void CommitTran();
+		void CommitTran(CommitOptions^ options);
+		int TryCommitTran();
+		int TryCommitTran(CommitOptions^ options);
 		void RollbackTran();
+		// Runs body in a transaction, retrying with jittered backoff on write conflicts
+		void RunTransaction(TransactionBody^ body);
+		// Returns the error code of the last attempt instead of throwing it
+		int TryRunTransaction(TransactionBody^ body, TransactionOptions^ options, CommitOptions^ commitOptions, int maxAttempts);
+		void PrepareTran(System::UInt64 prepareTimestamp);
+		void TimestampTran(System::String^ config);
+		void TransactionSync(System::String^ config);
 		void Checkpoint(System::String^ config);
 		void Compact(System::String^ name, System::String^ config);
 		void Create(System::String^ name, System::String^ config);
 		void Drop(System::String^ name, System::String^ config);
+		void Truncate(System::String^ name, Range range);
 		void Rename(System::String^ oldName, System::String^ newName, System::String^ config);
 		void Upgrade(System::String^ name, System::String^ config);
 		void Verify(System::String^ name, System::String^ config);
 		Cursor^ OpenCursor(System::String^ name);
 		Cursor^ OpenCursor(System::String^ name, System::String^ config);
+		// Disposing a cached cursor resets it and keeps it open for the next OpenCachedCursor
+		// with the same name and config, bulk and backup cursors must not be cached
+		Cursor^ OpenCachedCursor(System::String^ name);
+		Cursor^ OpenCachedCursor(System::String^ name, System::String^ config);
+		property int CursorCacheSize {
+			int get() { return cursorCacheSize_; }
+			void set(int value);
+		}
+		BulkLoader^ OpenBulkLoader(System::String^ name, System::String^ tempDirectory);
+		BulkLoader^ OpenBulkLoader(System::String^ name, System::String^ tempDirectory, __int64 runBytes, int threads);
+		TableStatistics GetTableStatistics(System::String^ uri, bool fast);
+		// Splits range into at most n parts of uri balanced by rows, in key order. Parts are right open
+		// at the next part's left boundary, so together they cover range exactly. Boundaries come from keys
+		// sampled with a next_random cursor, or from all keys when table statistics show the table is small.
+		array<Range>^ GetSplitPoints(System::String^ uri, Range range, int n);
+		array<Range>^ GetSplitPoints(System::String^ uri, Range range, int n, SplitBalance balance);
 	protected:
 		virtual void Close() override;
 	internal:
 		Session(WT_SESSION *session, WiredTigerComponent^ connection);
+		// Rolls back a transaction left open by BeginTran and resets all cursors of the session,
+		// returns false when the session could not be reset and must not be reused
+		bool ResetForPool();
+		void RemoveBulkLoader(BulkLoader^ loader);
 	private:
 		WT_SESSION* session_;
+		System::Collections::Generic::List<BulkLoader^>^ bulkLoaders_;
+		NativeCursorCache* cursorCache_;
+		int cursorCacheSize_;
+		bool inTransaction_;
+
+		[System::Runtime::InteropServices::UnmanagedFunctionPointer(System::Runtime::InteropServices::CallingConvention::Cdecl)]
+		delegate int InvokeBodyDelegate(void* context);
+		int InvokeBody(void* context);
+		InvokeBodyDelegate^ invokeBodyDelegate_;
+		TransactionBody^ body_;
+		System::Exception^ bodyException_;
 	};
 
+	ref class SessionPool;
+	ref class WriteBatcher;
+	ref class AsyncOperation;
+	ref class AsyncDispatcher;
+	ref class CompletionDispatcher;
+	ref class EventDrainer;
+	ref class ParallelScan;
+
 	public ref class Connection : public WiredTigerComponent {
 	public:
 		Session^ OpenSession();
+		SessionPool^ CreateSessionPool(int maxSize);
+		SessionPool^ CreateSessionPool(int maxSize, System::TimeSpan idleTimeout);
+		WriteBatcher^ CreateWriteBatcher(int writers);
+		// Each writer owns a session and commits up to maxBatchSize writes per transaction, waiting up
+		// to maxDelay for more writes before committing. commitOptions are used for every commit.
+		WriteBatcher^ CreateWriteBatcher(int writers, int maxBatchSize, System::TimeSpan maxDelay, CommitOptions^ commitOptions);
 		System::String^ GetHome();
+		ConnectionStatistics GetStatistics(bool fast);
+		// Counts keys of range on threads sessions of their own. The range is split into partitions at keys sampled
+		// with a next_random cursor, threads steal partitions from each other. Every thread reads its own snapshot.
+		__int64 ParallelCount(System::String^ uri, Range range, int threads);
+		// Scans range on threads sessions of their own, rows are read with ParallelScan.ReadBatch. Ordered scans
+		// return rows in key order, unordered ones as partitions are read, which keeps all threads busy.
+		ParallelScan^ OpenParallelScan(System::String^ uri, Range range, int threads, bool ordered);
+
+		// Latency tracking of cursor operations is process wide and off by default,
+		// snapshots are cumulative since the process start
+		static property bool LatencyTracking {
+			bool get();
+			void set(bool value);
+		}
+		static array<LatencyHistogram^>^ GetLatencySnapshot();
+
+		// Async operations run on WiredTiger async worker threads, the connection must be opened
+		// with async=(enabled=true). Tasks are completed on thread pool threads.
+		// SearchAsync completes with null when the key is not found, RemoveAsync with false.
+		// Tables must have key_format=u and value_format=u, others throw ArgumentException.
+		System::Threading::Tasks::Task<array<Byte>^>^ SearchAsync(System::String^ uri, array<Byte>^ key);
+		System::Threading::Tasks::Task^ InsertAsync(System::String^ uri, array<Byte>^ key, array<Byte>^ value);
+		System::Threading::Tasks::Task^ InsertAsync(System::String^ uri, System::String^ config, array<Byte>^ key, array<Byte>^ value);
+		System::Threading::Tasks::Task^ UpdateAsync(System::String^ uri, array<Byte>^ key, array<Byte>^ value);
+		System::Threading::Tasks::Task<bool>^ RemoveAsync(System::String^ uri, array<Byte>^ key);
+		// Waits until all submitted async operations are complete
+		void AsyncFlush();
+
 		static Connection^ Open(System::String^ home, System::String^ config, IEventHandler^ eventHandler);
 		static Connection^ Open(System::String^ home, System::String^ config, System::String^ closeConfig, IEventHandler^ eventHandler);
+		// With a positive eventBufferCapacity WiredTiger threads write events into a native ring buffer
+		// and eventHandler is called on a background thread. Events that do not fit are dropped and counted.
+		static Connection^ Open(System::String^ home, System::String^ config, System::String^ closeConfig, IEventHandler^ eventHandler,
+			int eventBufferCapacity);
+		// Events lost because the event buffer was full
+		property __int64 DroppedErrors {
+			__int64 get();
+		}
+		property __int64 DroppedMessages {
+			__int64 get();
+		}
+		property __int64 DroppedProgress {
+			__int64 get();
+		}
 	protected:
 		virtual void Close() override;
+	internal:
+		void RemoveParallelScan(ParallelScan^ scan);
 	private:
 		WT_CONNECTION* connection_;
-		Connection(System::String^ closeConfig, IEventHandler^ eventHandler);
+		AsyncDispatcher^ asyncDispatcher_;
+		System::Collections::Generic::List<WriteBatcher^>^ writeBatchers_;
+		System::Collections::Generic::List<ParallelScan^>^ parallelScans_;
+		// Statistics may be read from any thread, so they get their own session
+		WT_SESSION* statisticsSession_;
+		System::Object^ statisticsLock_;
+		Connection(System::String^ closeConfig, IEventHandler^ eventHandler, int eventBufferCapacity);
+		AsyncDispatcher^ GetAsyncDispatcher();
 
 		[System::Runtime::InteropServices::UnmanagedFunctionPointer(System::Runtime::InteropServices::CallingConvention::Cdecl)]
 		delegate int OnErrorDelegate(WT_EVENT_HANDLER *handler, WT_SESSION *session, int error, const char* message);
@@ -199,8 +628,116 @@ namespace WiredTigerNet {
 		int OnMessage(WT_EVENT_HANDLER *handler, WT_SESSION *session, const char* message);
 		OnMessageDelegate^ onMessageDelegate_;
 
+		[System::Runtime::InteropServices::UnmanagedFunctionPointer(System::Runtime::InteropServices::CallingConvention::Cdecl)]
+		delegate int OnProgressDelegate(const char* operation, unsigned __int64 progress);
+		int OnProgress(const char* operation, unsigned __int64 progress);
+		OnProgressDelegate^ onProgressDelegate_;
+
 		WT_EVENT_HANDLER* nativeEventHandler_;
+		NativeEventHandler* directEventHandler_;
 		IEventHandler^ eventHandler_;
+		EventDrainer^ eventDrainer_;
 		System::String^ closeConfig_;
 	};
+
+	public ref class PooledSession {
+	public:
+		~PooledSession();
+		!PooledSession();
+		property WiredTigerNet::Session^ Session {
+			WiredTigerNet::Session^ get();
+		}
+	internal:
+		PooledSession(SessionPool^ pool, WiredTigerNet::Session^ session);
+	private:
+		SessionPool^ pool_;
+		WiredTigerNet::Session^ session_;
+	};
+
+	// Bounded pool of sessions; a thread gets back the session it used last when it is idle.
+	// Sessions are returned by disposing PooledSession and keep their cached cursors open. On return an open
+	// transaction is rolled back and cursors are reset, a session that fails to reset is closed instead.
+	public ref class SessionPool : public WiredTigerComponent {
+	public:
+		PooledSession^ Rent();
+		PooledSession^ Rent(System::TimeSpan timeout);
+		// Closes sessions idle for longer than idleTime, returns the number of closed sessions
+		int Trim(System::TimeSpan idleTime);
+		property int MaxSize {
+			int get() { return maxSize_; }
+		}
+		property int OpenCount {
+			int get() { return openCount_; }
+		}
+		property int IdleCount {
+			int get();
+		}
+		// Number of rented sessions that were garbage collected without being disposed
+		property int LeakedCount {
+			int get() { return leakedCount_; }
+		}
+	protected:
+		virtual void Close() override;
+	internal:
+		SessionPool(Connection^ connection, int maxSize, System::TimeSpan idleTimeout);
+		void Return(Session^ session);
+		void Leaked();
+	private:
+		ref class IdleSession {
+		public:
+			Session^ session;
+			int threadId;
+			__int64 returnedAt;
+		};
+		Connection^ connection_;
+		int maxSize_;
+		System::TimeSpan idleTimeout_;
+		System::Collections::Generic::List<IdleSession^>^ idle_;
+		System::Object^ lock_;
+		int openCount_;
+		int leakedCount_;
+		bool closed_;
+		void CollectExpired(System::TimeSpan idleTime, System::Collections::Generic::List<Session^>^ expired);
+	};
+
+	// Coalesces writes of many threads into few transactions. Tasks complete once the
+	// transaction containing the write is committed, RemoveAsync completes with false
+	// when the key is not found. Disposing commits the writes enqueued so far. Tables must have
+	// key_format=u and value_format=u or none, writes to other tables fail with EINVAL.
+	public ref class WriteBatcher : public WiredTigerComponent {
+	public:
+		System::Threading::Tasks::Task^ InsertAsync(System::String^ uri, array<Byte>^ key, array<Byte>^ value);
+		System::Threading::Tasks::Task^ InsertAsync(System::String^ uri, array<Byte>^ key);
+		System::Threading::Tasks::Task<bool>^ RemoveAsync(System::String^ uri, array<Byte>^ key);
+		property __int64 Writes {
+			__int64 get();
+		}
+		property __int64 Transactions {
+			__int64 get();
+		}
+	protected:
+		virtual void Close() override;
+	internal:
+		WriteBatcher(NativeWriteBatcher* batcher, CompletionDispatcher^ completions, WiredTigerComponent^ connection);
+	private:
+		NativeWriteBatcher* batcher_;
+		CompletionDispatcher^ completions_;
+		System::Threading::ReaderWriterLockSlim^ closeLock_;
+		void Enqueue(NativeWriteOpType type, System::String^ uri, array<Byte>^ key, array<Byte>^ value, AsyncOperation^ operation);
+	};
+
+	// Rows of Connection.OpenParallelScan. Scan threads stop when the scan is disposed, or when the connection
+	// is closed. ReadBatch throws the first failure of any scan thread.
+	public ref class ParallelScan : public WiredTigerComponent {
+	public:
+		// Returns 0 once the scan is complete
+		int ReadBatch(KeyValueBatch^ batch);
+	protected:
+		virtual void Close() override;
+	internal:
+		ParallelScan(NativeParallelScan* scan, Connection^ connection);
+	private:
+		NativeParallelScan* scan_;
+		Connection^ connection_;
+	};
 }
\ No newline at end of file